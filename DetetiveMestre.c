@@ -1,22 +1,83 @@
+#define _GNU_SOURCE // sched_getcpu
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
 
 // Definições de tamanho
 #define MAX_NOME 50
-#define MAX_PISTA 100
 #define MAX_SUSPEITO 50
 #define TAM_HASH 10 // Tamanho pequeno para demonstração
+#define PISTAS_MINIMAS 3 // Mínimo de pistas para uma acusação 'forte'
+
+// Armazém de pistas comprimidas
+#define SEM_PISTA -1        // Id de pista para cômodos sem pista
+#define MAX_SIMBOLOS 255    // Símbolos do dicionário (o código 255 é o escape)
+#define CODIGO_ESCAPE 255
+#define TAM_SIMBOLO 8       // Tamanho máximo de um símbolo, em bytes
 
 // -------------------------------------------------------------------
 // 1. ESTRUTURAS DE DADOS
 // -------------------------------------------------------------------
 
+// Armazém de textos de pista: cada texto distinto é guardado uma única vez,
+// comprimido com um dicionário compartilhado, e referenciado por um id inteiro.
+typedef struct ArmazemPistas {
+    // Dicionário: símbolo 'c' tem tamanhoSimbolo[c] bytes em simbolo[c]. Os
+    // vetores têm 'simbolos' posições; sem símbolos, os textos ficam literais
+    int simbolos;
+    int treinado;
+    const unsigned char* tamanhoSimbolo;
+    const unsigned char (*simbolo)[TAM_SIMBOLO];
+    const short* primeiroPorByte; // Lista de símbolos por primeiro byte (256 posições)
+    const short* proximoMesmoByte;
+    // Textos comprimidos: o texto 'id' ocupa dados[inicio[id] .. inicio[id+1]-1]
+    int quantidade, capacidade;
+    const uint32_t* inicio;
+    const uint32_t* comprimento;  // Tamanho original de cada texto
+    const unsigned char* dados;
+    size_t usado, capacidadeDados;
+    // Os mesmos vetores, graváveis, quando alocados pelo próprio armazém.
+    // Num armazém fixo (tabela gerada, seção 16) ficam NULL.
+    struct {
+        unsigned char* tamanhoSimbolo;
+        unsigned char (*simbolo)[TAM_SIMBOLO];
+        short* primeiroPorByte;
+        short* proximoMesmoByte;
+        uint32_t* inicio;
+        uint32_t* comprimento;
+        unsigned char* dados;
+    } proprio;
+    // Deduplicação (endereçamento aberto sobre os bytes comprimidos)
+    int* hash;
+    size_t capacidadeHash;
+} ArmazemPistas;
+
 // Estrutura para o NÓ DA BST (Pistas Coletadas - Chave de busca: texto da pista)
 typedef struct PistaBST {
-    char texto[MAX_PISTA];
+    int texto; // Id do texto no armazém de pistas
     // Novo: Armazena o nome do suspeito associado a esta pista
     char suspeito[MAX_SUSPEITO];
     struct PistaBST *esquerda;
@@ -26,13 +87,43 @@ typedef struct PistaBST {
 // Estrutura para o CÔMODO (Nó do Mapa da Mansão)
 typedef struct Comodo {
     char nome[MAX_NOME];
-    char pista[MAX_PISTA];
+    int pista; // Id do texto no armazém de pistas (SEM_PISTA se não houver)
     char suspeito_associado[MAX_SUSPEITO]; // Novo: Quem a pista incrimina
     int pistaColetada;
+    int id; // Índice do cômodo no mapa indexado (-1 até a indexação)
     struct Comodo* esquerda;
     struct Comodo* direita;
 } Comodo;
 
+// Cômodo como o mapa indexado o enxerga: textos e filhos por id (pré-ordem,
+// raiz no id 0). É o formato das tabelas geradas em tempo de compilação
+// (seção 16); para árvores montadas em execução, indexarMapa cria o mesmo
+// vetor. O mapa só lê os cômodos; o que muda durante a partida fica fora.
+typedef struct ComodoIndexado {
+    const char* nome;
+    int pista;                      // id no armazém de pistas (SEM_PISTA se não houver)
+    const char* suspeito_associado;
+    int esquerda, direita;          // Ids dos filhos (-1 se não houver)
+} ComodoIndexado;
+
+// Mapa pré-processado para navegação e consultas de rota (seção 8). Os ids
+// seguem a pré-ordem da árvore, então a subárvore de um cômodo 'c' ocupa o
+// intervalo [c, fimSubarvore[c]]. Depois de indexado, o mapa é somente leitura.
+typedef struct MapaIndexado {
+    int quantidade;
+    const ComodoIndexado* comodos;
+    const int* pai;                 // -1 na raiz
+    const int* profundidade;
+    const int* fimSubarvore;
+    const int* porNome;             // Ids em ordem de nome (busca binária)
+    // Tabela esparsa de mínimos sobre o percurso em pré-ordem (variante do
+    // Euler tour com n entradas em vez de 2n-1): esparsa[k * quantidade + i]
+    // guarda o id de menor profundidade no intervalo [i, i + 2^k).
+    int niveis;
+    const int* esparsa;
+    void* bloco;                    // Memória única dos vetores acima (NULL numa tabela gerada)
+} MapaIndexado;
+
 // Estrutura para o NÓ DA LISTA ENCADEADA na Tabela Hash (Item da Hash)
 typedef struct NoHash {
     char suspeito[MAX_SUSPEITO];
@@ -45,9 +136,540 @@ typedef struct TabelaHash {
     NoHash* buckets[TAM_HASH];
 } TabelaHash;
 
+// Veredito de uma acusação, pelo número de pistas contra o acusado (seção 7).
+// Os valores também são gravados no arquivo de sessões exportadas.
+typedef enum Veredito {
+    VEREDITO_SEM_BASE,
+    VEREDITO_INSUFICIENTE,
+    VEREDITO_SUSTENTAVEL
+} Veredito;
+
+// Resumo por subárvore das pistas ainda não coletadas (definido na seção 13)
+typedef struct ResumoSubarvores ResumoSubarvores;
+
+
+// -------------------------------------------------------------------
+// 2. ARMAZÉM DE PISTAS (TEXTO COMPRIMIDO)
+// -------------------------------------------------------------------
+
+// Compressão no estilo FSST: até 255 símbolos de 1 a 8 bytes, treinados sobre
+// os textos do caso. Cada símbolo vira um byte de código; bytes sem símbolo
+// saem como CODIGO_ESCAPE seguido do byte literal. Um armazém sem dicionário
+// (antes do treino, ou quando o dicionário custaria mais do que economiza)
+// guarda os textos literais.
+
+void inicializarArmazem(ArmazemPistas* armazem) {
+    memset(armazem, 0, sizeof(*armazem));
+}
+
+void* realocarArmazem(void* bloco, size_t tamanho) {
+    void* novo = realloc(bloco, tamanho);
+    if (novo == NULL) {
+        perror("Erro na alocação de memória para o armazém de pistas");
+        exit(EXIT_FAILURE);
+    }
+    return novo;
+}
+
+// Próxima unidade do texto: código do símbolo mais longo que casa (0..254)
+// ou 256 + byte quando nenhum símbolo começa ali. '*tamanho' recebe os bytes consumidos.
+static int proximaUnidade(const ArmazemPistas* armazem, const unsigned char* texto, size_t resto, int* tamanho) {
+    // As listas por primeiro byte estão ordenadas do símbolo mais longo ao mais curto
+    int primeiro = armazem->simbolos > 0 ? armazem->primeiroPorByte[texto[0]] : -1;
+    for (int c = primeiro; c >= 0; c = armazem->proximoMesmoByte[c]) {
+        size_t t = armazem->tamanhoSimbolo[c];
+        if (t <= resto && memcmp(armazem->simbolo[c], texto, t) == 0) {
+            *tamanho = (int)t;
+            return c;
+        }
+    }
+    *tamanho = 1;
+    return 256 + texto[0];
+}
+
+// Comprime 'tamanho' bytes em 'saida' (capacidade mínima: 2 * tamanho). Retorna os bytes escritos.
+size_t comprimirTexto(const ArmazemPistas* armazem, const char* texto, size_t tamanho, unsigned char* saida) {
+    if (armazem->simbolos == 0) {
+        memcpy(saida, texto, tamanho);
+        return tamanho;
+    }
+    const unsigned char* p = (const unsigned char*)texto;
+    size_t escritos = 0;
+    while (tamanho > 0) {
+        int consumidos;
+        int unidade = proximaUnidade(armazem, p, tamanho, &consumidos);
+        if (unidade < 256) {
+            saida[escritos++] = (unsigned char)unidade;
+        } else {
+            saida[escritos++] = CODIGO_ESCAPE;
+            saida[escritos++] = (unsigned char)(unidade - 256);
+        }
+        p += consumidos;
+        tamanho -= (size_t)consumidos;
+    }
+    return escritos;
+}
+
+// Refaz as listas de busca por primeiro byte (mais longos primeiro)
+static void indexarSimbolos(ArmazemPistas* armazem) {
+    short* primeiroPorByte = armazem->proprio.primeiroPorByte;
+    if (primeiroPorByte == NULL) return;
+    for (int i = 0; i < 256; i++) primeiroPorByte[i] = -1;
+    for (int t = 1; t <= TAM_SIMBOLO; t++) {
+        for (int c = 0; c < armazem->simbolos; c++) {
+            if (armazem->tamanhoSimbolo[c] != t) continue;
+            unsigned char primeiro = armazem->simbolo[c][0];
+            armazem->proprio.proximoMesmoByte[c] = primeiroPorByte[primeiro];
+            primeiroPorByte[primeiro] = (short)c;
+        }
+    }
+}
+
+// Ajusta os vetores do dicionário para 'simbolos' posições
+static void reservarDicionario(ArmazemPistas* armazem, int simbolos) {
+    armazem->proprio.tamanhoSimbolo = (unsigned char*)realocarArmazem(armazem->proprio.tamanhoSimbolo, (size_t)simbolos);
+    armazem->proprio.simbolo = (unsigned char (*)[TAM_SIMBOLO])realocarArmazem(armazem->proprio.simbolo,
+                                                                               (size_t)simbolos * TAM_SIMBOLO);
+    armazem->proprio.proximoMesmoByte = (short*)realocarArmazem(armazem->proprio.proximoMesmoByte,
+                                                                sizeof(short) * (size_t)simbolos);
+    if (armazem->proprio.primeiroPorByte == NULL) {
+        armazem->proprio.primeiroPorByte = (short*)realocarArmazem(NULL, sizeof(short) * 256);
+        for (int i = 0; i < 256; i++) armazem->proprio.primeiroPorByte[i] = -1;
+    }
+    armazem->tamanhoSimbolo = armazem->proprio.tamanhoSimbolo;
+    armazem->simbolo = (const unsigned char (*)[TAM_SIMBOLO])armazem->proprio.simbolo;
+    armazem->proximoMesmoByte = armazem->proprio.proximoMesmoByte;
+    armazem->primeiroPorByte = armazem->proprio.primeiroPorByte;
+}
+
+// Volta ao armazenamento literal (não recomprime os textos)
+static void descartarDicionario(ArmazemPistas* armazem) {
+    free(armazem->proprio.tamanhoSimbolo);
+    free(armazem->proprio.simbolo);
+    free(armazem->proprio.primeiroPorByte);
+    free(armazem->proprio.proximoMesmoByte);
+    armazem->proprio.tamanhoSimbolo = NULL;
+    armazem->proprio.simbolo = NULL;
+    armazem->proprio.primeiroPorByte = NULL;
+    armazem->proprio.proximoMesmoByte = NULL;
+    armazem->tamanhoSimbolo = NULL;
+    armazem->simbolo = NULL;
+    armazem->primeiroPorByte = NULL;
+    armazem->proximoMesmoByte = NULL;
+    armazem->simbolos = 0;
+}
+
+// Bytes ocupados pelo dicionário
+static size_t memoriaDicionario(const ArmazemPistas* armazem) {
+    if (armazem->simbolos == 0) return 0;
+    return (size_t)armazem->simbolos * (TAM_SIMBOLO + 1 + sizeof(short)) + sizeof(short) * 256;
+}
+
+typedef struct CandidatoSimbolo {
+    unsigned char bytes[TAM_SIMBOLO];
+    int tamanho;
+    long long ganho;
+} CandidatoSimbolo;
+
+static int compararCandidatoPorTexto(const void* a, const void* b) {
+    const CandidatoSimbolo* x = (const CandidatoSimbolo*)a;
+    const CandidatoSimbolo* y = (const CandidatoSimbolo*)b;
+    if (x->tamanho != y->tamanho) return x->tamanho - y->tamanho;
+    return memcmp(x->bytes, y->bytes, (size_t)x->tamanho);
+}
+
+static int compararCandidatoPorGanho(const void* a, const void* b) {
+    const CandidatoSimbolo* x = (const CandidatoSimbolo*)a;
+    const CandidatoSimbolo* y = (const CandidatoSimbolo*)b;
+    if (x->ganho != y->ganho) return x->ganho > y->ganho ? -1 : 1;
+    return compararCandidatoPorTexto(a, b);
+}
+
+// Copia para 'bytes' o texto de uma unidade (símbolo atual ou byte literal) e retorna o tamanho
+static int bytesUnidade(const ArmazemPistas* armazem, int unidade, unsigned char* bytes) {
+    if (unidade >= 256) {
+        bytes[0] = (unsigned char)(unidade - 256);
+        return 1;
+    }
+    memcpy(bytes, armazem->simbolo[unidade], TAM_SIMBOLO);
+    return armazem->tamanhoSimbolo[unidade];
+}
+
+// Treina o dicionário sobre uma amostra dos textos do caso. A cada geração o
+// texto é recodificado com a tabela atual; símbolos e pares vizinhos (até 8
+// bytes) concorrem pelo ganho = frequência x tamanho, e os 255 melhores ficam.
+void treinarArmazem(ArmazemPistas* armazem, const char* const* textos, int quantidade) {
+    const int unidades = 512;
+    const size_t limiteAmostra = 1 << 16;
+    descartarDicionario(armazem);
+    reservarDicionario(armazem, MAX_SIMBOLOS);
+    long long* contagem = (long long*)calloc((size_t)unidades, sizeof(long long));
+    long long* pares = (long long*)calloc((size_t)unidades * (size_t)unidades, sizeof(long long));
+    size_t capacidadeCandidatos = 1024, totalCandidatos;
+    CandidatoSimbolo* candidatos = (CandidatoSimbolo*)realocarArmazem(NULL, sizeof(CandidatoSimbolo) * capacidadeCandidatos);
+    if (contagem == NULL || pares == NULL) {
+        perror("Erro na alocação de memória para o treino do dicionário");
+        exit(EXIT_FAILURE);
+    }
+
+    armazem->simbolos = 0;
+    indexarSimbolos(armazem);
+
+    for (int geracao = 0; geracao < 5; geracao++) {
+        memset(contagem, 0, sizeof(long long) * (size_t)unidades);
+        memset(pares, 0, sizeof(long long) * (size_t)unidades * (size_t)unidades);
+
+        size_t amostrados = 0;
+        for (int i = 0; i < quantidade && amostrados < limiteAmostra; i++) {
+            const unsigned char* p = (const unsigned char*)textos[i];
+            size_t resto = strlen(textos[i]);
+            amostrados += resto;
+            int anterior = -1;
+            while (resto > 0) {
+                int consumidos;
+                int unidade = proximaUnidade(armazem, p, resto, &consumidos);
+                contagem[unidade]++;
+                if (anterior >= 0) pares[anterior * unidades + unidade]++;
+                anterior = unidade;
+                p += consumidos;
+                resto -= (size_t)consumidos;
+            }
+        }
+
+        totalCandidatos = 0;
+        for (int u = 0; u < unidades; u++) {
+            if (contagem[u] == 0) continue;
+            if (totalCandidatos + unidades + 1 > capacidadeCandidatos) {
+                capacidadeCandidatos *= 2;
+                candidatos = (CandidatoSimbolo*)realocarArmazem(candidatos, sizeof(CandidatoSimbolo) * capacidadeCandidatos);
+            }
+            CandidatoSimbolo* unico = &candidatos[totalCandidatos++];
+            memset(unico->bytes, 0, TAM_SIMBOLO);
+            unico->tamanho = bytesUnidade(armazem, u, unico->bytes);
+            unico->ganho = contagem[u] * unico->tamanho;
+            for (int v = 0; v < unidades; v++) {
+                long long vezes = pares[u * unidades + v];
+                if (vezes == 0) continue;
+                unsigned char bytesV[TAM_SIMBOLO];
+                int tamanhoV = bytesUnidade(armazem, v, bytesV);
+                int tamanhoU = candidatos[totalCandidatos - 1].tamanho;
+                if (tamanhoU + tamanhoV > TAM_SIMBOLO) continue;
+                CandidatoSimbolo* par = &candidatos[totalCandidatos++];
+                memcpy(par->bytes, unico->bytes, TAM_SIMBOLO);
+                memcpy(par->bytes + tamanhoU, bytesV, (size_t)tamanhoV);
+                par->tamanho = tamanhoU + tamanhoV;
+                par->ganho = vezes * par->tamanho;
+            }
+        }
+
+        // Candidatos repetidos (mesmo texto vindo de pares diferentes) somam o ganho
+        qsort(candidatos, totalCandidatos, sizeof(CandidatoSimbolo), compararCandidatoPorTexto);
+        size_t unicos = 0;
+        for (size_t i = 0; i < totalCandidatos; i++) {
+            if (unicos > 0 && compararCandidatoPorTexto(&candidatos[unicos - 1], &candidatos[i]) == 0) {
+                candidatos[unicos - 1].ganho += candidatos[i].ganho;
+            } else {
+                candidatos[unicos++] = candidatos[i];
+            }
+        }
+        qsort(candidatos, unicos, sizeof(CandidatoSimbolo), compararCandidatoPorGanho);
+
+        armazem->simbolos = unicos < MAX_SIMBOLOS ? (int)unicos : MAX_SIMBOLOS;
+        for (int c = 0; c < armazem->simbolos; c++) {
+            memcpy(armazem->proprio.simbolo[c], candidatos[c].bytes, TAM_SIMBOLO);
+            armazem->proprio.tamanhoSimbolo[c] = (unsigned char)candidatos[c].tamanho;
+        }
+        indexarSimbolos(armazem);
+    }
+
+    armazem->treinado = 1;
+    if (armazem->simbolos == 0) descartarDicionario(armazem);
+    else reservarDicionario(armazem, armazem->simbolos);
+    free(contagem);
+    free(pares);
+    free(candidatos);
+}
+
+static uint64_t hashBytes(const unsigned char* dados, size_t tamanho) {
+    uint64_t hash = 1469598103934665603ull; // FNV-1a
+    for (size_t i = 0; i < tamanho; i++) {
+        hash ^= dados[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static inline const unsigned char* dadosPista(const ArmazemPistas* armazem, int id) {
+    return armazem->dados + armazem->inicio[id];
+}
+
+static inline size_t tamanhoComprimido(const ArmazemPistas* armazem, int id) {
+    return armazem->inicio[id + 1] - armazem->inicio[id];
+}
+
+// Procura 'comprimido' na tabela de deduplicação; retorna a posição do id ou da vaga
+static size_t localizarDuplicata(const ArmazemPistas* armazem, const unsigned char* comprimido, size_t tamanho) {
+    size_t mascara = armazem->capacidadeHash - 1;
+    size_t pos = (size_t)hashBytes(comprimido, tamanho) & mascara;
+    while (armazem->hash[pos] >= 0) {
+        int id = armazem->hash[pos];
+        if (tamanhoComprimido(armazem, id) == tamanho && memcmp(dadosPista(armazem, id), comprimido, tamanho) == 0) break;
+        pos = (pos + 1) & mascara;
+    }
+    return pos;
+}
+
+static void crescerDeduplicacao(ArmazemPistas* armazem) {
+    size_t capacidade = armazem->capacidadeHash ? armazem->capacidadeHash * 2 : 64;
+    free(armazem->hash);
+    armazem->hash = (int*)realocarArmazem(NULL, sizeof(int) * capacidade);
+    armazem->capacidadeHash = capacidade;
+    for (size_t i = 0; i < capacidade; i++) armazem->hash[i] = -1;
+    for (int id = 0; id < armazem->quantidade; id++) {
+        armazem->hash[localizarDuplicata(armazem, dadosPista(armazem, id), tamanhoComprimido(armazem, id))] = id;
+    }
+}
+
+// Registra o texto de uma pista e retorna seu id (SEM_PISTA para texto vazio).
+// Textos iguais recebem o mesmo id. Sem dicionário, o texto é guardado literal
+// (retreinarArmazem recomprime tudo depois). Não é seguro para chamadas simultâneas.
+int registrarPista(ArmazemPistas* armazem, const char* texto) {
+    if (texto == NULL || texto[0] == '\0') return SEM_PISTA;
+    size_t tamanho = strlen(texto);
+
+    unsigned char local[512];
+    unsigned char* comprimido = 2 * tamanho <= sizeof(local) ? local : (unsigned char*)realocarArmazem(NULL, 2 * tamanho);
+    size_t tamanhoFinal = comprimirTexto(armazem, texto, tamanho, comprimido);
+
+    if ((size_t)(armazem->quantidade + 1) * 2 > armazem->capacidadeHash) crescerDeduplicacao(armazem);
+    size_t vaga = localizarDuplicata(armazem, comprimido, tamanhoFinal);
+    if (armazem->hash[vaga] >= 0) {
+        if (comprimido != local) free(comprimido);
+        return armazem->hash[vaga];
+    }
+
+    if (armazem->quantidade + 1 >= armazem->capacidade) {
+        int nova = armazem->capacidade ? armazem->capacidade * 2 : 64;
+        armazem->proprio.inicio = (uint32_t*)realocarArmazem(armazem->proprio.inicio, sizeof(uint32_t) * ((size_t)nova + 1));
+        armazem->proprio.comprimento = (uint32_t*)realocarArmazem(armazem->proprio.comprimento,
+                                                                  sizeof(uint32_t) * (size_t)nova);
+        armazem->inicio = armazem->proprio.inicio;
+        armazem->comprimento = armazem->proprio.comprimento;
+        armazem->capacidade = nova;
+    }
+    if (armazem->usado + tamanhoFinal > armazem->capacidadeDados) {
+        size_t nova = armazem->capacidadeDados ? armazem->capacidadeDados * 2 : 4096;
+        while (nova < armazem->usado + tamanhoFinal) nova *= 2;
+        armazem->proprio.dados = (unsigned char*)realocarArmazem(armazem->proprio.dados, nova);
+        armazem->dados = armazem->proprio.dados;
+        armazem->capacidadeDados = nova;
+    }
+
+    int id = armazem->quantidade++;
+    armazem->proprio.inicio[id] = (uint32_t)armazem->usado;
+    memcpy(armazem->proprio.dados + armazem->usado, comprimido, tamanhoFinal);
+    armazem->usado += tamanhoFinal;
+    armazem->proprio.inicio[id + 1] = (uint32_t)armazem->usado;
+    armazem->proprio.comprimento[id] = (uint32_t)tamanho;
+    armazem->hash[vaga] = id;
+
+    if (comprimido != local) free(comprimido);
+    return id;
+}
+
+// Tamanho original (descomprimido) de uma pista
+size_t comprimentoPista(const ArmazemPistas* armazem, int id) {
+    return id == SEM_PISTA ? 0 : armazem->comprimento[id];
+}
+
+// Descomprime a pista em 'destino' (sempre terminado em '\0', truncando se faltar
+// espaço) e retorna o tamanho original. Com folga de TAM_SIMBOLO bytes, cada
+// código vira uma cópia fixa de 8 bytes, sem laço por caractere.
+size_t decodificarPista(const ArmazemPistas* armazem, int id, char* destino, size_t capacidade) {
+    if (capacidade == 0) return comprimentoPista(armazem, id);
+    if (id == SEM_PISTA) {
+        destino[0] = '\0';
+        return 0;
+    }
+    const unsigned char* p = dadosPista(armazem, id);
+    const unsigned char* fim = p + tamanhoComprimido(armazem, id);
+    size_t tamanho = armazem->comprimento[id];
+    char* saida = destino;
+
+    if (armazem->simbolos == 0) {
+        size_t copiados = tamanho < capacidade - 1 ? tamanho : capacidade - 1;
+        memcpy(destino, p, copiados);
+        destino[copiados] = '\0';
+        return tamanho;
+    }
+    if (tamanho + TAM_SIMBOLO < capacidade) {
+        while (p < fim) {
+            unsigned char codigo = *p++;
+            if (codigo == CODIGO_ESCAPE) {
+                *saida++ = (char)*p++;
+            } else {
+                memcpy(saida, armazem->simbolo[codigo], TAM_SIMBOLO);
+                saida += armazem->tamanhoSimbolo[codigo];
+            }
+        }
+    } else {
+        char* limite = destino + capacidade - 1;
+        while (p < fim && saida < limite) {
+            unsigned char codigo = *p++;
+            if (codigo == CODIGO_ESCAPE) {
+                *saida++ = (char)*p++;
+            } else {
+                const char* simbolo = (const char*)armazem->simbolo[codigo];
+                for (int i = 0; i < armazem->tamanhoSimbolo[codigo] && saida < limite; i++) *saida++ = simbolo[i];
+            }
+        }
+    }
+    *saida = '\0';
+    return tamanho;
+}
+
+// Retreina o dicionário sobre os textos já registrados e os recomprime.
+// Os ids não mudam. Útil depois de montar um caso inteiro.
+void retreinarArmazem(ArmazemPistas* armazem) {
+    if (armazem->quantidade == 0) return;
+
+    // Descomprime tudo com o dicionário atual
+    size_t total = 0;
+    for (int id = 0; id < armazem->quantidade; id++) total += armazem->comprimento[id] + 1;
+    char* textos = (char*)realocarArmazem(NULL, total + TAM_SIMBOLO);
+    const char** ponteiros = (const char**)realocarArmazem(NULL, sizeof(char*) * (size_t)armazem->quantidade);
+    size_t pos = 0;
+    for (int id = 0; id < armazem->quantidade; id++) {
+        ponteiros[id] = textos + pos;
+        pos += decodificarPista(armazem, id, textos + pos, total + TAM_SIMBOLO - pos) + 1;
+    }
+
+    treinarArmazem(armazem, ponteiros, armazem->quantidade);
+
+    // Recomprime na mesma ordem, preservando os ids. Em casos pequenos o
+    // dicionário pode custar mais do que economiza: aí os textos ficam literais
+    size_t capacidade = 2 * total;
+    unsigned char* dados = (unsigned char*)realocarArmazem(NULL, capacidade > 0 ? capacidade : 1);
+    size_t usado = 0, literal = total - (size_t)armazem->quantidade;
+    for (int id = 0; id < armazem->quantidade; id++) {
+        armazem->proprio.inicio[id] = (uint32_t)usado;
+        usado += comprimirTexto(armazem, ponteiros[id], armazem->comprimento[id], dados + usado);
+    }
+    if (armazem->simbolos > 0 && usado + memoriaDicionario(armazem) >= literal) {
+        descartarDicionario(armazem);
+        usado = 0;
+        for (int id = 0; id < armazem->quantidade; id++) {
+            armazem->proprio.inicio[id] = (uint32_t)usado;
+            usado += comprimirTexto(armazem, ponteiros[id], armazem->comprimento[id], dados + usado);
+        }
+    }
+    armazem->proprio.inicio[armazem->quantidade] = (uint32_t)usado;
+    free(armazem->proprio.dados);
+    armazem->proprio.dados = (unsigned char*)realocarArmazem(dados, usado > 0 ? usado : 1);
+    armazem->dados = armazem->proprio.dados;
+    armazem->usado = armazem->capacidadeDados = usado;
+
+    // Os bytes comprimidos mudaram: refaz a deduplicação
+    armazem->capacidadeHash /= 2;
+    crescerDeduplicacao(armazem);
+
+    free(textos);
+    free(ponteiros);
+}
+
+// Leitura byte a byte de uma pista comprimida, sem buffer do texto inteiro
+typedef struct LeitorPista {
+    const ArmazemPistas* armazem;
+    const unsigned char* p;
+    const unsigned char* fim;
+    const unsigned char* simbolo;
+    int restante;       // bytes ainda não entregues de 'simbolo'
+} LeitorPista;
+
+static void iniciarLeitor(LeitorPista* leitor, const ArmazemPistas* armazem, int id, size_t deslocamento) {
+    leitor->armazem = armazem;
+    leitor->p = id == SEM_PISTA ? NULL : dadosPista(armazem, id) + deslocamento;
+    leitor->fim = id == SEM_PISTA ? NULL : dadosPista(armazem, id) + tamanhoComprimido(armazem, id);
+    leitor->restante = 0;
+}
+
+// Próximo byte do texto ou -1 no fim
+static inline int lerByte(LeitorPista* leitor) {
+    if (leitor->restante == 0) {
+        if (leitor->p >= leitor->fim) return -1;
+        unsigned char codigo = *leitor->p++;
+        if (leitor->armazem->simbolos == 0) return codigo;
+        if (codigo == CODIGO_ESCAPE) return *leitor->p++;
+        leitor->simbolo = leitor->armazem->simbolo[codigo];
+        leitor->restante = leitor->armazem->tamanhoSimbolo[codigo];
+    }
+    leitor->restante--;
+    return *leitor->simbolo++;
+}
+
+// Compara duas pistas como strcmp, sem descomprimir o texto inteiro.
+// Ids iguais são textos iguais (deduplicação); o prefixo comum dos códigos é
+// pulado direto sobre os bytes comprimidos, e só o resto é decodificado.
+int compararPistas(const ArmazemPistas* armazem, int a, int b) {
+    if (a == b) return 0;
+    if (a == SEM_PISTA) return -1;
+    if (b == SEM_PISTA) return 1;
+
+    const unsigned char* x = dadosPista(armazem, a);
+    const unsigned char* y = dadosPista(armazem, b);
+    size_t tamanhoX = tamanhoComprimido(armazem, a);
+    size_t tamanhoY = tamanhoComprimido(armazem, b);
+    size_t comum = 0;
+    while (comum < tamanhoX && comum < tamanhoY && x[comum] == y[comum]) {
+        size_t passo = x[comum] == CODIGO_ESCAPE && armazem->simbolos > 0 ? 2 : 1;
+        if (passo == 2 && (comum + 1 >= tamanhoX || comum + 1 >= tamanhoY || x[comum + 1] != y[comum + 1])) break;
+        comum += passo;
+    }
+
+    LeitorPista lx, ly;
+    iniciarLeitor(&lx, armazem, a, comum);
+    iniciarLeitor(&ly, armazem, b, comum);
+    while (1) {
+        int bx = lerByte(&lx);
+        int by = lerByte(&ly);
+        if (bx != by || bx < 0) return bx - by;
+    }
+}
+
+// Escreve a pista inteira em 'saida', em pedaços, sem limite de tamanho
+void imprimirPista(const ArmazemPistas* armazem, int id, FILE* saida) {
+    char pedaco[256];
+    size_t usados = 0;
+    LeitorPista leitor;
+    iniciarLeitor(&leitor, armazem, id, 0);
+    int byte;
+    while ((byte = lerByte(&leitor)) >= 0) {
+        pedaco[usados++] = (char)byte;
+        if (usados == sizeof(pedaco)) {
+            fwrite(pedaco, 1, usados, saida);
+            usados = 0;
+        }
+    }
+    if (usados > 0) fwrite(pedaco, 1, usados, saida);
+}
+
+// Bytes ocupados pelo armazém (dicionário, textos, índices e deduplicação)
+size_t memoriaArmazem(const ArmazemPistas* armazem) {
+    return sizeof(*armazem) + memoriaDicionario(armazem) + armazem->usado +
+           sizeof(uint32_t) * ((size_t)armazem->quantidade * 2 + 1) + sizeof(int) * armazem->capacidadeHash;
+}
+
+void liberarArmazem(ArmazemPistas* armazem) {
+    descartarDicionario(armazem);
+    free(armazem->proprio.inicio);
+    free(armazem->proprio.comprimento);
+    free(armazem->proprio.dados);
+    free(armazem->hash);
+    inicializarArmazem(armazem);
+}
 
 // -------------------------------------------------------------------
-// 2. FUNÇÕES DA TABELA HASH (ASSOCIAÇÃO SUSPEITO-PISTA)
+// 3. FUNÇÕES DA TABELA HASH (ASSOCIAÇÃO SUSPEITO-PISTA)
 // -------------------------------------------------------------------
 
 // Função Hash: Simples, baseada na soma dos caracteres
@@ -67,16 +689,15 @@ void inicializarHash(TabelaHash* tabela) {
 }
 
 // Incrementa a contagem de pistas para um suspeito na Tabela Hash
-void incrementarContagemSuspeito(TabelaHash* tabela, const char* nomeSuspeito) {
+// sem mensagens, e retorna a nova contagem
+int somarPistaSuspeito(TabelaHash* tabela, const char* nomeSuspeito) {
     unsigned int indice = calcularHash(nomeSuspeito);
     NoHash* atual = tabela->buckets[indice];
 
     // 1. Procura o nó existente
     while (atual != NULL) {
         if (strcmp(atual->suspeito, nomeSuspeito) == 0) {
-            atual->contagem_pistas++;
-            printf("  [Hash]: Contagem de pistas para **%s** incrementada para %d.\n", nomeSuspeito, atual->contagem_pistas);
-            return;
+            return ++atual->contagem_pistas;
         }
         atual = atual->proximo;
     }
@@ -95,7 +716,17 @@ void incrementarContagemSuspeito(TabelaHash* tabela, const char* nomeSuspeito) {
     // Insere no início da lista encadeada (bucket)
     novoNo->proximo = tabela->buckets[indice];
     tabela->buckets[indice] = novoNo;
-    printf("  [Hash]: Novo suspeito **%s** adicionado à Hash com 1 pista.\n", nomeSuspeito);
+    return 1;
+}
+
+// Incrementa a contagem de pistas para um suspeito na Tabela Hash
+void incrementarContagemSuspeito(TabelaHash* tabela, const char* nomeSuspeito) {
+    int contagem = somarPistaSuspeito(tabela, nomeSuspeito);
+    if (contagem == 1) {
+        printf("  [Hash]: Novo suspeito **%s** adicionado à Hash com 1 pista.\n", nomeSuspeito);
+    } else {
+        printf("  [Hash]: Contagem de pistas para **%s** incrementada para %d.\n", nomeSuspeito, contagem);
+    }
 }
 
 // Retorna a contagem de pistas para um suspeito (ou 0 se não encontrado)
@@ -125,18 +756,17 @@ void liberarHash(TabelaHash* tabela) {
 }
 
 // -------------------------------------------------------------------
-// 3. FUNÇÕES DA BST (PISTAS)
+// 4. FUNÇÕES DA BST (PISTAS)
 // -------------------------------------------------------------------
 
 // Cria um novo nó de pista para a BST
-PistaBST* criarPistaBST(const char* texto, const char* suspeito) {
+PistaBST* criarPistaBST(int texto, const char* suspeito) {
     PistaBST* novaPista = (PistaBST*)malloc(sizeof(PistaBST));
     if (novaPista == NULL) {
         perror("Erro na alocação de memória para PistaBST");
         exit(EXIT_FAILURE);
     }
-    strncpy(novaPista->texto, texto, MAX_PISTA - 1);
-    novaPista->texto[MAX_PISTA - 1] = '\0';
+    novaPista->texto = texto;
     strncpy(novaPista->suspeito, suspeito, MAX_SUSPEITO - 1);
     novaPista->suspeito[MAX_SUSPEITO - 1] = '\0';
     novaPista->esquerda = novaPista->direita = NULL;
@@ -144,47 +774,99 @@ PistaBST* criarPistaBST(const char* texto, const char* suspeito) {
 }
 
 // Insere uma pista na BST (organização alfabética pelo texto da pista)
-PistaBST* inserirPistaBST(PistaBST* raiz, const char* texto, const char* suspeito) {
+PistaBST* inserirPistaBST(PistaBST* raiz, const ArmazemPistas* armazem, int texto, const char* suspeito) {
     if (raiz == NULL) {
         return criarPistaBST(texto, suspeito);
     }
 
-    int comparacao = strcmp(texto, raiz->texto);
+    int comparacao = compararPistas(armazem, texto, raiz->texto);
 
     if (comparacao < 0) {
-        raiz->esquerda = inserirPistaBST(raiz->esquerda, texto, suspeito);
+        raiz->esquerda = inserirPistaBST(raiz->esquerda, armazem, texto, suspeito);
     } else if (comparacao > 0) {
-        raiz->direita = inserirPistaBST(raiz->direita, texto, suspeito);
+        raiz->direita = inserirPistaBST(raiz->direita, armazem, texto, suspeito);
     }
 
     return raiz;
 }
 
 // Travessia In-Order para exibir as pistas em ordem alfabética
-void exibirPistasEmOrdem(PistaBST* raiz) {
+void exibirPistasEmOrdem(PistaBST* raiz, const ArmazemPistas* armazem) {
     if (raiz != NULL) {
-        exibirPistasEmOrdem(raiz->esquerda);
-        printf(" -> Pista: \"%s\" | Suspeito Associado: %s\n", raiz->texto, raiz->suspeito);
-        exibirPistasEmOrdem(raiz->direita);
+        exibirPistasEmOrdem(raiz->esquerda, armazem);
+        printf(" -> Pista: \"");
+        imprimirPista(armazem, raiz->texto, stdout);
+        printf("\" | Suspeito Associado: %s\n", raiz->suspeito);
+        exibirPistasEmOrdem(raiz->direita, armazem);
     }
 }
 
-// Libera a memória da BST de Pistas
+// Libera a memória da BST de Pistas sem recursão: rotações à direita trazem o
+// filho esquerdo para cima até o nó atual não ter esquerda, então ele é liberado.
+// Memória extra O(1), seguro mesmo em árvores degeneradas.
 void liberarPistas(PistaBST* raiz) {
-    if (raiz != NULL) {
-        liberarPistas(raiz->esquerda);
-        liberarPistas(raiz->direita);
-        free(raiz);
+    while (raiz != NULL) {
+        if (raiz->esquerda != NULL) {
+            PistaBST* esquerda = raiz->esquerda;
+            raiz->esquerda = esquerda->direita;
+            esquerda->direita = raiz;
+            raiz = esquerda;
+        } else {
+            PistaBST* direita = raiz->direita;
+            free(raiz);
+            raiz = direita;
+        }
     }
 }
 
 // -------------------------------------------------------------------
-// 4. FUNÇÕES DO MAPA (ÁRVORE BINÁRIA)
+// 5. FUNÇÕES DO MAPA (ÁRVORE BINÁRIA)
 // -------------------------------------------------------------------
 
-// Cria um novo nó (cômodo) com pista e suspeito
-Comodo* criarComodo(const char* nome, const char* pista, const char* suspeito) {
-    Comodo* novoComodo = (Comodo*)malloc(sizeof(Comodo));
+// Arena de cômodos: blocos grandes e contíguos, liberados de uma só vez.
+// Cômodos da arena não podem ser passados para liberarMapa.
+#define COMODOS_POR_BLOCO 4096
+
+typedef struct BlocoComodos {
+    struct BlocoComodos* proximo;
+    int usados;
+    Comodo comodos[COMODOS_POR_BLOCO];
+} BlocoComodos;
+
+typedef struct ArenaComodos {
+    BlocoComodos* blocos;
+} ArenaComodos;
+
+void inicializarArena(ArenaComodos* arena) {
+    arena->blocos = NULL;
+}
+
+Comodo* alocarComodo(ArenaComodos* arena) {
+    if (arena == NULL) return (Comodo*)malloc(sizeof(Comodo));
+    if (arena->blocos == NULL || arena->blocos->usados == COMODOS_POR_BLOCO) {
+        BlocoComodos* bloco = (BlocoComodos*)malloc(sizeof(BlocoComodos));
+        if (bloco == NULL) return NULL;
+        bloco->usados = 0;
+        bloco->proximo = arena->blocos;
+        arena->blocos = bloco;
+    }
+    return &arena->blocos->comodos[arena->blocos->usados++];
+}
+
+// Libera todos os cômodos da arena, um bloco por vez
+void liberarArena(ArenaComodos* arena) {
+    BlocoComodos* bloco = arena->blocos;
+    while (bloco != NULL) {
+        BlocoComodos* proximo = bloco->proximo;
+        free(bloco);
+        bloco = proximo;
+    }
+    arena->blocos = NULL;
+}
+
+// Cria um novo nó (cômodo) com pista e suspeito, na arena ou no heap (arena NULL)
+Comodo* criarComodoEm(ArenaComodos* arena, const char* nome, int pista, const char* suspeito) {
+    Comodo* novoComodo = alocarComodo(arena);
     if (novoComodo == NULL) {
         perror("Erro na alocação de memória para Comodo");
         exit(EXIT_FAILURE);
@@ -193,116 +875,324 @@ Comodo* criarComodo(const char* nome, const char* pista, const char* suspeito) {
     strncpy(novoComodo->nome, nome, MAX_NOME - 1);
     novoComodo->nome[MAX_NOME - 1] = '\0';
 
-    strncpy(novoComodo->pista, pista, MAX_PISTA - 1);
-    novoComodo->pista[MAX_PISTA - 1] = '\0';
+    novoComodo->pista = pista;
 
     strncpy(novoComodo->suspeito_associado, suspeito, MAX_SUSPEITO - 1);
     novoComodo->suspeito_associado[MAX_SUSPEITO - 1] = '\0';
 
     novoComodo->pistaColetada = 0;
+    novoComodo->id = -1;
     novoComodo->esquerda = NULL;
     novoComodo->direita = NULL;
 
     return novoComodo;
 }
 
+// Cria um novo nó (cômodo) com pista e suspeito; o texto da pista vai para o armazém
+Comodo* criarComodo(ArmazemPistas* armazem, const char* nome, const char* pista, const char* suspeito) {
+    return criarComodoEm(NULL, nome, registrarPista(armazem, pista), suspeito);
+}
+
 // Monta o mapa da mansão com pistas e associações (montagem automática)
-Comodo* montarMapa() {
+// O texto das pistas vai para 'armazem', e o dicionário é treinado sobre o caso.
+Comodo* montarMapa(ArmazemPistas* armazem) {
     // Nível 0 - Raiz
-    Comodo* hallEntrada = criarComodo("Hall de Entrada", "A porta principal estava trancada por dentro.", "Elias");
+    Comodo* hallEntrada = criarComodo(armazem, "Hall de Entrada", "A porta principal estava trancada por dentro.", "Elias");
 
     // Nível 1
-    Comodo* salaEstar = criarComodo("Sala de Estar", "Um bilhete rasgado menciona 'encontro na despensa'.", "Diana");
-    Comodo* cozinha = criarComodo("Cozinha", "", ""); // Cômodo sem pista
+    Comodo* salaEstar = criarComodo(armazem, "Sala de Estar", "Um bilhete rasgado menciona 'encontro na despensa'.", "Diana");
+    Comodo* cozinha = criarComodo(armazem, "Cozinha", "", ""); // Cômodo sem pista
     hallEntrada->esquerda = salaEstar;
     hallEntrada->direita = cozinha;
 
     // Nível 2
-    Comodo* quartoPrincipal = criarComodo("Quarto Principal", "O diário menciona um relógio de ouro.", "Elias");
-    Comodo* banheiro = criarComodo("Banheiro", "Uma luva de seda vermelha foi encontrada próxima ao lavabo.", "Bruno");
+    Comodo* quartoPrincipal = criarComodo(armazem, "Quarto Principal", "O diário menciona um relógio de ouro.", "Elias");
+    Comodo* banheiro = criarComodo(armazem, "Banheiro", "Uma luva de seda vermelha foi encontrada próxima ao lavabo.", "Bruno");
     salaEstar->esquerda = quartoPrincipal;
     salaEstar->direita = banheiro;
 
-    Comodo* despensa = criarComodo("Despensa", "Uma lanterna quebrada e marcas de pés enlameados.", "Diana"); // Fim de caminho
+    Comodo* despensa = criarComodo(armazem, "Despensa", "Uma lanterna quebrada e marcas de pés enlameados.", "Diana"); // Fim de caminho
     cozinha->esquerda = despensa;
 
     // Nível 3
-    Comodo* varanda = criarComodo("Varanda", "O relógio de ouro estava caído no parapeito.", "Elias"); // Fim de caminho
+    Comodo* varanda = criarComodo(armazem, "Varanda", "O relógio de ouro estava caído no parapeito.", "Elias"); // Fim de caminho
     quartoPrincipal->esquerda = varanda;
 
     // A solução (culpado) é Elias, com 3 pistas (Hall, Quarto, Varanda).
 
+    retreinarArmazem(armazem);
     return hallEntrada;
 }
 
-// Libera a memória da árvore de cômodos (Mapa)
+// Gerador pseudoaleatório (xorshift32): determinístico e sem estado global
+unsigned int proximoAleatorio(unsigned int* estado) {
+    unsigned int x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *estado = x;
+    return x;
+}
+
+// Catálogo das mansões geradas: cada frase-base aparece com VARIACOES_PISTA
+// numerações diferentes, o que dá textos distintos mas parecidos entre si.
+#define VARIACOES_PISTA 200
+
+static const char* FRASES_GERADAS[] = {
+    "Pegadas de lama seguem para o jardim.",
+    "Um lenço bordado com iniciais foi esquecido.",
+    "A janela foi forçada pelo lado de fora.",
+    "Cinzas de charuto ainda mornas no cinzeiro.",
+    "Uma página arrancada do livro de visitas."
+};
+static const char* SUSPEITOS_GERADOS[] = { "Elias", "Diana", "Bruno", "Helena", "Otávio" };
+#define TOTAL_FRASES_GERADAS ((int)(sizeof(FRASES_GERADAS) / sizeof(FRASES_GERADAS[0])))
+#define TOTAL_SUSPEITOS_GERADOS ((int)(sizeof(SUSPEITOS_GERADOS) / sizeof(SUSPEITOS_GERADOS[0])))
+#define TOTAL_PISTAS_GERADAS (TOTAL_FRASES_GERADAS * VARIACOES_PISTA)
+
+// Registra o catálogo no armazém (treinando o dicionário) e retorna os ids,
+// para que a geração em várias threads não precise registrar textos.
+int* registrarCatalogoGerado(ArmazemPistas* armazem) {
+    int* ids = (int*)malloc(sizeof(int) * TOTAL_PISTAS_GERADAS);
+    if (ids == NULL) {
+        perror("Erro na alocação de memória para o catálogo de pistas");
+        exit(EXIT_FAILURE);
+    }
+    char texto[160];
+    for (int i = 0; i < TOTAL_PISTAS_GERADAS; i++) {
+        snprintf(texto, sizeof(texto), "%s Indício nº %d.", FRASES_GERADAS[i % TOTAL_FRASES_GERADAS],
+                 i / TOTAL_FRASES_GERADAS + 1);
+        ids[i] = registrarPista(armazem, texto);
+    }
+    retreinarArmazem(armazem);
+    return ids;
+}
+
+// Gera uma subárvore aleatória com 'quantidade' cômodos, numerados a partir de
+// 'primeiro'. Cada novo cômodo ocupa uma saída livre sorteada entre as existentes,
+// sem recursão. Com 'arena' NULL, os cômodos vêm do heap. As pistas saem de
+// 'catalogo' (ids de registrarCatalogoGerado).
+Comodo* gerarSubarvore(int primeiro, int quantidade, unsigned int semente, ArenaComodos* arena,
+                       const int* catalogo) {
+    if (quantidade <= 0) return NULL;
+    unsigned int estado = semente != 0 ? semente : 2463534242u;
+
+    // Saídas livres: (cômodo, lado). Cada cômodo criado consome uma e abre duas.
+    Comodo** saidasComodo = (Comodo**)malloc(sizeof(Comodo*) * ((size_t)quantidade + 1));
+    char* saidasLado = (char*)malloc((size_t)quantidade + 1);
+    if (saidasComodo == NULL || saidasLado == NULL) {
+        perror("Erro na alocação de memória para o gerador de mansão");
+        exit(EXIT_FAILURE);
+    }
+
+    char nome[MAX_NOME];
+    Comodo* raiz = NULL;
+    int livres = 0;
+
+    for (int i = 0; i < quantidade; i++) {
+        int pista = SEM_PISTA;
+        const char* suspeito = "";
+        if (proximoAleatorio(&estado) % 3 == 0) {
+            pista = catalogo[proximoAleatorio(&estado) % TOTAL_PISTAS_GERADAS];
+            suspeito = SUSPEITOS_GERADOS[proximoAleatorio(&estado) % TOTAL_SUSPEITOS_GERADOS];
+        }
+        snprintf(nome, sizeof(nome), "Cômodo %d", primeiro + i);
+        Comodo* novo = criarComodoEm(arena, nome, pista, suspeito);
+
+        if (raiz == NULL) {
+            raiz = novo;
+        } else {
+            // Sorteia uma saída livre e a remove trocando pela última
+            int sorteada = (int)(proximoAleatorio(&estado) % (unsigned int)livres);
+            Comodo* pai = saidasComodo[sorteada];
+            if (saidasLado[sorteada] == 'E') pai->esquerda = novo;
+            else pai->direita = novo;
+            livres--;
+            saidasComodo[sorteada] = saidasComodo[livres];
+            saidasLado[sorteada] = saidasLado[livres];
+        }
+
+        // Só abre as saídas que ainda podem ser ocupadas
+        if (livres < quantidade - i) {
+            saidasComodo[livres] = novo;
+            saidasLado[livres++] = 'E';
+        }
+        if (livres < quantidade - i) {
+            saidasComodo[livres] = novo;
+            saidasLado[livres++] = 'D';
+        }
+    }
+
+    free(saidasComodo);
+    free(saidasLado);
+    return raiz;
+}
+
+// Gera uma mansão aleatória com 'quantidade' cômodos (usada em testes de escala)
+Comodo* gerarMansao(int quantidade, unsigned int semente, ArmazemPistas* armazem) {
+    int* catalogo = registrarCatalogoGerado(armazem);
+    Comodo* raiz = gerarSubarvore(0, quantidade, semente, NULL, catalogo);
+    free(catalogo);
+    return raiz;
+}
+
+// Libera a memória da árvore de cômodos (Mapa) sem recursão, pelas mesmas
+// rotações de liberarPistas: não estoura a pilha em mansões degeneradas.
 void liberarMapa(Comodo* comodo) {
-    if (comodo == NULL) return;
-    liberarMapa(comodo->esquerda);
-    liberarMapa(comodo->direita);
-    free(comodo);
+    while (comodo != NULL) {
+        if (comodo->esquerda != NULL) {
+            Comodo* esquerda = comodo->esquerda;
+            comodo->esquerda = esquerda->direita;
+            esquerda->direita = comodo;
+            comodo = esquerda;
+        } else {
+            Comodo* direita = comodo->direita;
+            free(comodo);
+            comodo = direita;
+        }
+    }
+}
+
+// Memória das pistas antes (buffer fixo de 100 bytes no Comodo e na PistaBST)
+// e depois do armazém comprimido, para uma mansão já montada
+void relatarMemoriaPistas(const char* titulo, Comodo* raiz, const ArmazemPistas* armazem) {
+    const size_t bufferAntigo = 100; // char pista[MAX_PISTA] / char texto[MAX_PISTA]
+    int comodos = 0, comPista = 0;
+    size_t textoOriginal = 0;
+
+    size_t capacidade = 64, topo = 0;
+    Comodo** pilha = (Comodo**)malloc(sizeof(Comodo*) * capacidade);
+    if (pilha == NULL) {
+        perror("Erro na alocação de memória para o relatório");
+        return;
+    }
+    if (raiz != NULL) pilha[topo++] = raiz;
+    while (topo > 0) {
+        Comodo* atual = pilha[--topo];
+        comodos++;
+        if (atual->pista != SEM_PISTA) {
+            comPista++;
+            textoOriginal += comprimentoPista(armazem, atual->pista);
+        }
+        if (topo + 2 > capacidade) {
+            capacidade *= 2;
+            Comodo** maior = (Comodo**)realloc(pilha, sizeof(Comodo*) * capacidade);
+            if (maior == NULL) break;
+            pilha = maior;
+        }
+        if (atual->esquerda != NULL) pilha[topo++] = atual->esquerda;
+        if (atual->direita != NULL) pilha[topo++] = atual->direita;
+    }
+    free(pilha);
+
+    size_t distintosOriginal = 0;
+    for (int id = 0; id < armazem->quantidade; id++) distintosOriginal += armazem->comprimento[id];
+    size_t dicionario = 0;
+    for (int c = 0; c < armazem->simbolos; c++) dicionario += armazem->tamanhoSimbolo[c];
+
+    size_t antes = (size_t)comodos * bufferAntigo + (size_t)comPista * bufferAntigo;
+    size_t depois = (size_t)comodos * sizeof(int) + (size_t)comPista * sizeof(int) + memoriaArmazem(armazem);
+
+    printf("--- %s ---\n", titulo);
+    printf("Cômodos: %d | com pista: %d | textos distintos: %d | dicionário: %d símbolos, %zu bytes\n",
+           comodos, comPista, armazem->quantidade, armazem->simbolos, dicionario);
+    printf("Texto das pistas: %zu bytes (%zu distintos) -> %zu bytes comprimidos (%.1f%%)\n",
+           textoOriginal, distintosOriginal, armazem->usado,
+           distintosOriginal > 0 ? 100.0 * (double)armazem->usado / (double)distintosOriginal : 0.0);
+    printf("Antes:  %zu bytes (%.1f por pista coletável, contando Comodo e PistaBST)\n",
+           antes, comPista > 0 ? (double)antes / comPista : 0.0);
+    printf("Depois: %zu bytes (%.1f por pista coletável, com ids e armazém)\n",
+           depois, comPista > 0 ? (double)depois / comPista : 0.0);
+}
+
+int medirMemoriaPistas(int quantidade) {
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = montarMapa(&armazem);
+    relatarMemoriaPistas("Mansão de demonstração", mansao, &armazem);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+
+    inicializarArmazem(&armazem);
+    mansao = gerarMansao(quantidade, 31337u, &armazem);
+    relatarMemoriaPistas("Mansão gerada", mansao, &armazem);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return 0;
 }
 
 // -------------------------------------------------------------------
-// 5. SIMULAÇÃO DA EXPLORAÇÃO
+// 6. SIMULAÇÃO DA EXPLORAÇÃO
 // -------------------------------------------------------------------
 
-void explorar(Comodo* atual, PistaBST** raiz_pistas, TabelaHash* hash_suspeitos) {
-    if (atual == NULL) return;
+void marcarPistaColetada(ResumoSubarvores* resumo, int comodo, int coletada);
+int pistaColetada(const ResumoSubarvores* resumo, int comodo);
+void exibirDicaSubarvore(const ResumoSubarvores* resumo, int comodo);
 
-    Comodo* proximo = NULL;
+// Navega pelo mapa indexado a partir do Hall de Entrada (id 0). O estado da
+// partida (pistas já coletadas) fica em 'resumo', que também dá a cada
+// cômodo a dica do que ainda falta encontrar abaixo; a mansão não é alterada.
+void explorar(const MapaIndexado* mapa, PistaBST** raiz_pistas, TabelaHash* hash_suspeitos,
+              const ArmazemPistas* armazem, ResumoSubarvores* resumo) {
+    if (mapa->quantidade == 0) return;
+
+    int atual = 0;
+    int proximo = -1;
     char escolha;
 
     printf("\n🚨 Você é o detetive e precisa encontrar o culpado! 🚨\n");
 
-    while (atual != NULL) {
+    while (1) {
+        const ComodoIndexado* comodo = &mapa->comodos[atual];
         printf("\n========================================================\n");
-        printf("--- LOCAL ATUAL: **%s** ---\n", atual->nome);
+        printf("--- LOCAL ATUAL: **%s** ---\n", comodo->nome);
 
         // LÓGICA DE COLETA DE PISTAS E HASH
-        if (strlen(atual->pista) > 0 && atual->pistaColetada == 0) {
+        if (comodo->pista != SEM_PISTA && !pistaColetada(resumo, atual)) {
             printf("\n🔎 **PISTA ENCONTRADA!**\n");
 
             // 1. Insere a pista na BST
-            *raiz_pistas = inserirPistaBST(*raiz_pistas, atual->pista, atual->suspeito_associado);
+            *raiz_pistas = inserirPistaBST(*raiz_pistas, armazem, comodo->pista, comodo->suspeito_associado);
 
             // 2. Associa a pista ao suspeito na Tabela Hash
-            incrementarContagemSuspeito(hash_suspeitos, atual->suspeito_associado);
+            incrementarContagemSuspeito(hash_suspeitos, comodo->suspeito_associado);
 
-            // 3. Marca como coletada
-            atual->pistaColetada = 1;
-            printf("  [Sistema]: Pista incrimina **%s** e foi registrada.\n", atual->suspeito_associado);
-        } else if (strlen(atual->pista) > 0 && atual->pistaColetada == 1) {
+            // 3. Marca como coletada (e atualiza o resumo até a raiz)
+            marcarPistaColetada(resumo, atual, 1);
+            printf("  [Sistema]: Pista incrimina **%s** e foi registrada.\n", comodo->suspeito_associado);
+        } else if (comodo->pista != SEM_PISTA) {
              printf("ℹ️ Pista já coletada neste cômodo.\n");
         } else {
              printf("O cômodo parece limpo. Nenhuma pista visível aqui.\n");
         }
 
+        exibirDicaSubarvore(resumo, atual);
+
         // Verifica se há caminhos disponíveis (folha da árvore)
-        if (atual->esquerda == NULL && atual->direita == NULL) {
+        if (comodo->esquerda < 0 && comodo->direita < 0) {
             printf("\n🛑 **FIM DA LINHA!** A exploração da mansão terminou.\n");
             break;
         }
 
         // MOSTRA OPÇÕES
         printf("\nPara onde você quer ir? (E/D/F-Finalizar)\n");
-        if (atual->esquerda != NULL) printf("   **[E]squerda** -> %s\n", atual->esquerda->nome);
-        if (atual->direita != NULL) printf("   **[D]ireita** -> %s\n", atual->direita->nome);
+        if (comodo->esquerda >= 0) printf("   **[E]squerda** -> %s\n", mapa->comodos[comodo->esquerda].nome);
+        if (comodo->direita >= 0) printf("   **[D]ireita** -> %s\n", mapa->comodos[comodo->direita].nome);
         printf("   **[F]inalizar** -> Encerrar a exploração e fazer a acusação.\n");
 
         printf("Escolha: ");
         scanf(" %c", &escolha);
         escolha = toupper(escolha);
 
-        proximo = NULL;
+        proximo = -1;
 
         switch (escolha) {
             case 'E':
-                if (atual->esquerda != NULL) proximo = atual->esquerda;
+                if (comodo->esquerda >= 0) proximo = comodo->esquerda;
                 else printf("Caminho não existe.\n");
                 break;
             case 'D':
-                if (atual->direita != NULL) proximo = atual->direita;
+                if (comodo->direita >= 0) proximo = comodo->direita;
                 else printf("Caminho não existe.\n");
                 break;
             case 'F':
@@ -313,16 +1203,32 @@ void explorar(Comodo* atual, PistaBST** raiz_pistas, TabelaHash* hash_suspeitos)
                 continue;
         }
 
-        if (proximo != NULL) {
+        if (proximo >= 0) {
             atual = proximo; // Move para o próximo cômodo
         }
     }
 }
 
 // -------------------------------------------------------------------
-// 6. AVALIAÇÃO FINAL
+// 7. AVALIAÇÃO FINAL
 // -------------------------------------------------------------------
 
+// Nome do veredito no protocolo do servidor e no resumo das sessões exportadas
+static const char* const NOMES_VEREDITO[] = { "SEM_BASE", "INSUFICIENTE", "SUSTENTAVEL" };
+
+// Título do veredito no jogo interativo (a conferência do servidor o lê de volta)
+static const char* const TITULOS_VEREDITO[] = {
+    "❌ **VEREDITO: ACUSAÇÃO SEM BASE!**",
+    "⚠️ **VEREDITO: PROVAS INSUFICIENTES!**",
+    "✅ **VEREDITO: ACUSAÇÃO SUSTENTÁVEL!**",
+};
+
+// Regra única do veredito: o jogo, o servidor e a exportação passam por aqui
+Veredito classificarVeredito(int pistas) {
+    if (pistas >= PISTAS_MINIMAS) return VEREDITO_SUSTENTAVEL;
+    return pistas > 0 ? VEREDITO_INSUFICIENTE : VEREDITO_SEM_BASE;
+}
+
 void avaliarAcusacao(TabelaHash* hash_suspeitos) {
     char acusado[MAX_SUSPEITO];
     int pistas_acusacao;
@@ -335,9 +1241,6 @@ void avaliarAcusacao(TabelaHash* hash_suspeitos) {
     // Lê a linha inteira para pegar nomes compostos, se houver
     scanf(" %49[^\n]", acusado);
 
-    // Define o mínimo de pistas necessárias para uma acusação 'forte'
-    const int PISTAS_MINIMAS = 3;
-
     // Consulta a Tabela Hash para obter a contagem de pistas
     pistas_acusacao = obterContagemSuspeito(hash_suspeitos, acusado);
 
@@ -345,54 +1248,4006 @@ void avaliarAcusacao(TabelaHash* hash_suspeitos) {
     printf("Acusado: **%s**\n", acusado);
     printf("Pistas Coletadas que o incriminam: **%d**\n", pistas_acusacao);
 
-    if (pistas_acusacao >= PISTAS_MINIMAS) {
-        printf("\n✅ **VEREDITO: ACUSAÇÃO SUSTENTÁVEL!**\n");
+    Veredito veredito = classificarVeredito(pistas_acusacao);
+    printf("\n%s\n", TITULOS_VEREDITO[veredito]);
+    if (veredito == VEREDITO_SUSTENTAVEL) {
         printf("O número de %d pistas é suficiente para sustentar a acusação contra %s.\n", pistas_acusacao, acusado);
-    } else if (pistas_acusacao > 0) {
-        printf("\n⚠️ **VEREDITO: PROVAS INSUFICIENTES!**\n");
+    } else if (veredito == VEREDITO_INSUFICIENTE) {
         printf("Você precisa de pelo menos %d pistas. Apenas %d foram encontradas contra %s.\n", PISTAS_MINIMAS, pistas_acusacao, acusado);
     } else {
-        printf("\n❌ **VEREDITO: ACUSAÇÃO SEM BASE!**\n");
         printf("Nenhuma pista foi coletada que incrimine diretamente %s.\n", acusado);
     }
 }
 
 // -------------------------------------------------------------------
-// 7. FUNÇÃO PRINCIPAL
+// 8. MAPA INDEXADO E CONSULTAS DE ROTA
 // -------------------------------------------------------------------
 
-int main() {
-    PistaBST* pistas_coletadas = NULL;
-    TabelaHash hash_suspeitos;
+// Pistas ainda não coletadas mais próximas, por decomposição em centróides.
+// Cada cômodo está na componente de no máximo log2(n) + 1 centróides (seus
+// ancestrais na árvore de centróides), e a fila de um centróide lista as pistas
+// da sua componente em ordem de distância até ele. Todo caminho entre dois
+// cômodos passa pelo centróide mais alto que os separa; logo, a pista mais
+// próxima de 'origem' é o menor distancia(origem, c) + distancia(c, pista)
+// entre os centróides 'c' acima de 'origem', usando a primeira pista ainda
+// disponível de cada fila.
+typedef struct PistasProximas {
+    int quantidade;
+    int* paiCentroide;          // Centróide da componente em que este foi escolhido (-1 no primeiro)
+    int* cursor;                // Início da fila de cada centróide (avança sobre pistas coletadas)
+    int* fimFila;
+    int* fila;                  // Filas de todos os centróides, uma após a outra
+    unsigned char* disponivel;  // 1 se o cômodo tem pista ainda não coletada
+} PistasProximas;
 
-    // Inicializa a Tabela Hash antes do uso
-    inicializarHash(&hash_suspeitos);
+void* alocarIndice(size_t tamanho) {
+    void* bloco = malloc(tamanho);
+    if (bloco == NULL) {
+        perror("Erro na alocação de memória para o mapa indexado");
+        exit(EXIT_FAILURE);
+    }
+    return bloco;
+}
 
-    printf("--- Simulador de Mansão e Resolução de Caso (Árvore + BST + Hash) ---\n");
+int compararComodosPorNome(const void* a, const void* b) {
+    const Comodo* ca = *(const Comodo* const*)a;
+    const Comodo* cb = *(const Comodo* const*)b;
+    return strcmp(ca->nome, cb->nome);
+}
 
-    // 1. Monta o mapa (cria a árvore de cômodos)
-    Comodo* mansao = montarMapa();
+// Retorna o id de menor profundidade entre dois candidatos
+static inline int maisRaso(const MapaIndexado* mapa, int a, int b) {
+    return mapa->profundidade[a] <= mapa->profundidade[b] ? a : b;
+}
 
-    // 2. Inicia a exploração, coleta de pistas e associação via Hash
-    explorar(mansao, &pistas_coletadas, &hash_suspeitos);
+// Pré-processa a árvore em tempo linear (mais O(n log n) da tabela esparsa).
+// Percurso iterativo com pilha explícita: funciona em mansões degeneradas.
+// Os textos continuam na árvore, que precisa viver enquanto o mapa for usado.
+void indexarMapa(MapaIndexado* mapa, Comodo* raiz) {
+    memset(mapa, 0, sizeof(*mapa));
+    if (raiz == NULL) return;
 
-    // 3. Avaliação final e acusação
-    avaliarAcusacao(&hash_suspeitos);
+    // 1. Conta os cômodos para dimensionar os vetores
+    size_t capacidadePilha = 64;
+    Comodo** pilha = (Comodo**)alocarIndice(sizeof(Comodo*) * capacidadePilha);
+    size_t topo = 0;
+    int quantidade = 0;
+    pilha[topo++] = raiz;
+    while (topo > 0) {
+        Comodo* atual = pilha[--topo];
+        quantidade++;
+        if (topo + 2 > capacidadePilha) {
+            capacidadePilha *= 2;
+            pilha = (Comodo**)realloc(pilha, sizeof(Comodo*) * capacidadePilha);
+            if (pilha == NULL) {
+                perror("Erro na alocação de memória para o mapa indexado");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (atual->direita != NULL) pilha[topo++] = atual->direita;
+        if (atual->esquerda != NULL) pilha[topo++] = atual->esquerda;
+    }
 
-    // 4. Exibe o relatório de pistas coletadas
-    printf("\n========================================================\n");
-    printf("           📋 RELATÓRIO COMPLETO DE INDÍCIOS 📋          \n");
-    printf("========================================================\n");
-    if (pistas_coletadas != NULL) {
-        exibirPistasEmOrdem(pistas_coletadas);
-    } else {
-        printf("Nenhuma pista foi coletada.\n");
+    // Um único bloco: os cômodos (alinhados como ponteiros) e depois os vetores de int
+    size_t n = (size_t)quantidade;
+    int niveis = 1;
+    while ((1 << niveis) <= quantidade) niveis++;
+    ComodoIndexado* comodos = (ComodoIndexado*)alocarIndice(sizeof(ComodoIndexado) * n +
+                                                            sizeof(int) * n * (4 + (size_t)niveis));
+    int* pai = (int*)(comodos + n);
+    int* profundidade = pai + n;
+    int* fimSubarvore = profundidade + n;
+    int* porNome = fimSubarvore + n;
+    int* esparsa = porNome + n;
+    mapa->quantidade = quantidade;
+    mapa->comodos = comodos;
+    mapa->pai = pai;
+    mapa->profundidade = profundidade;
+    mapa->fimSubarvore = fimSubarvore;
+    mapa->porNome = porNome;
+    mapa->niveis = niveis;
+    mapa->esparsa = esparsa;
+    mapa->bloco = comodos;
+    Comodo** originais = (Comodo**)alocarIndice(sizeof(Comodo*) * n);
+
+    // 2. Pré-ordem: o id é a ordem de visita. O pai já tem id quando o filho sai da pilha.
+    int proximoId = 0;
+    topo = 0;
+    pilha[topo++] = raiz;
+    raiz->id = -1;
+    while (topo > 0) {
+        Comodo* atual = pilha[--topo];
+        int paiAtual = atual->id; // Antes da visita, 'id' carrega o id do pai
+        int id = proximoId++;
+        atual->id = id;
+        originais[id] = atual;
+        comodos[id].nome = atual->nome;
+        comodos[id].pista = atual->pista;
+        comodos[id].suspeito_associado = atual->suspeito_associado;
+        comodos[id].esquerda = -1;
+        comodos[id].direita = -1;
+        pai[id] = paiAtual;
+        profundidade[id] = paiAtual < 0 ? 0 : profundidade[paiAtual] + 1;
+        if (paiAtual >= 0) {
+            if (originais[paiAtual]->esquerda == atual) comodos[paiAtual].esquerda = id;
+            else comodos[paiAtual].direita = id;
+        }
+        if (atual->direita != NULL) {
+            atual->direita->id = id;
+            pilha[topo++] = atual->direita;
+        }
+        if (atual->esquerda != NULL) {
+            atual->esquerda->id = id;
+            pilha[topo++] = atual->esquerda;
+        }
     }
+    free(pilha);
 
-    // 5. Libera a memória alocada
-    printf("\n--- Fim da Simulação. Liberando memória ---\n");
-    liberarPistas(pistas_coletadas);
-    liberarMapa(mansao);
+    // 3. Fim de cada subárvore (de trás para frente: filhos antes dos pais)
+    for (int id = quantidade - 1; id >= 0; id--) {
+        if (comodos[id].direita >= 0) fimSubarvore[id] = fimSubarvore[comodos[id].direita];
+        else if (comodos[id].esquerda >= 0) fimSubarvore[id] = fimSubarvore[comodos[id].esquerda];
+        else fimSubarvore[id] = id;
+    }
+
+    // 4. Tabela esparsa para LCA em O(1)
+    for (int i = 0; i < quantidade; i++) esparsa[i] = i;
+    for (int k = 1; k < niveis; k++) {
+        int* nivel = esparsa + (size_t)k * n;
+        const int* anterior = esparsa + (size_t)(k - 1) * n;
+        int passo = 1 << (k - 1);
+        int i = 0;
+        for (; i + (1 << k) <= quantidade; i++) {
+            nivel[i] = maisRaso(mapa, anterior[i], anterior[i + passo]);
+        }
+        // O fim de cada nível (intervalos que passariam do último id) nunca é
+        // consultado; repete o nível anterior para a tabela ficar toda definida
+        for (; i < quantidade; i++) nivel[i] = anterior[i];
+    }
+
+    // 5. Índice por nome: ordena os nós originais e guarda os ids
+    qsort(originais, n, sizeof(Comodo*), compararComodosPorNome);
+    for (int i = 0; i < quantidade; i++) porNome[i] = originais[i]->id;
+    free(originais);
+}
+
+// Menor ancestral comum de dois cômodos em O(1)
+int lcaComodos(const MapaIndexado* mapa, int a, int b) {
+    if (a == b) return a;
+    if (a > b) { int t = a; a = b; b = t; }
+    // Se 'a' é ancestral de 'b', ele próprio é o LCA
+    if (b <= mapa->fimSubarvore[a]) return a;
+    // Senão, o LCA é o pai do cômodo mais raso no intervalo (a, b] da pré-ordem
+    int inicio = a + 1;
+    int tamanho = b - inicio + 1;
+    int k = 31 - __builtin_clz((unsigned int)tamanho);
+    const int* nivel = mapa->esparsa + (size_t)k * (size_t)mapa->quantidade;
+    int menor = maisRaso(mapa, nivel[inicio], nivel[b - (1 << k) + 1]);
+    return mapa->pai[menor];
+}
+
+// Número de passagens entre dois cômodos
+int distanciaComodos(const MapaIndexado* mapa, int a, int b) {
+    int ancestral = lcaComodos(mapa, a, b);
+    return mapa->profundidade[a] + mapa->profundidade[b] - 2 * mapa->profundidade[ancestral];
+}
+
+// Preenche 'rota' com os ids de 'origem' até 'destino' (inclusive) e retorna o tamanho.
+// 'rota' precisa de espaço para distanciaComodos(origem, destino) + 1 posições.
+int rotaEntreComodos(const MapaIndexado* mapa, int origem, int destino, int* rota) {
+    int ancestral = lcaComodos(mapa, origem, destino);
+    int tamanho = 0;
+
+    // Subida: origem -> ancestral
+    for (int c = origem; c != ancestral; c = mapa->pai[c]) rota[tamanho++] = c;
+    rota[tamanho++] = ancestral;
+
+    // Descida: ancestral -> destino (preenchida de trás para frente)
+    int descida = mapa->profundidade[destino] - mapa->profundidade[ancestral];
+    int pos = tamanho + descida - 1;
+    for (int c = destino; c != ancestral; c = mapa->pai[c]) rota[pos--] = c;
+    return tamanho + descida;
+}
+
+// Busca um cômodo pelo nome em O(log n). Retorna o id ou -1.
+int buscarComodoPorNome(const MapaIndexado* mapa, const char* nome) {
+    int inicio = 0, fim = mapa->quantidade - 1;
+    while (inicio <= fim) {
+        int meio = inicio + (fim - inicio) / 2;
+        int comparacao = strcmp(nome, mapa->comodos[mapa->porNome[meio]].nome);
+        if (comparacao == 0) return mapa->porNome[meio];
+        if (comparacao < 0) fim = meio - 1;
+        else inicio = meio + 1;
+    }
+    return -1;
+}
+
+// Busca em largura a partir de 'inicio' sem entrar em cômodos removidos.
+// Preenche 'ordem' (ordem de visita, que é a de distância até 'inicio') e
+// 'veioDe' (vizinho pelo qual cada cômodo foi alcançado); retorna quantos visitou.
+static int percorrerComponente(const MapaIndexado* mapa, const unsigned char* removido, int inicio,
+                               int* ordem, int* veioDe) {
+    int total = 0;
+    ordem[total++] = inicio;
+    veioDe[inicio] = -1;
+    for (int i = 0; i < total; i++) {
+        int atual = ordem[i];
+        int vizinhos[3] = { mapa->pai[atual], mapa->comodos[atual].esquerda, mapa->comodos[atual].direita };
+        for (int v = 0; v < 3; v++) {
+            int vizinho = vizinhos[v];
+            if (vizinho < 0 || vizinho == veioDe[atual] || removido[vizinho]) continue;
+            veioDe[vizinho] = atual;
+            ordem[total++] = vizinho;
+        }
+    }
+    return total;
+}
+
+// Monta a decomposição em centróides em O(n log n), sem recursão: cada nível
+// da árvore de centróides percorre no máximo n cômodos, e há até log2(n) + 1
+// níveis. As filas guardam só cômodos com pista, no máximo n(log2(n) + 1) posições.
+// Todas as pistas começam disponíveis; as coletas entram por coletarPistaProxima.
+void prepararPistasProximas(PistasProximas* proximas, const MapaIndexado* mapa) {
+    memset(proximas, 0, sizeof(*proximas));
+    int quantidade = mapa->quantidade;
+    if (quantidade == 0) return;
+    size_t n = (size_t)quantidade;
+    proximas->quantidade = quantidade;
+    proximas->paiCentroide = (int*)alocarIndice(sizeof(int) * n);
+    proximas->cursor = (int*)alocarIndice(sizeof(int) * n);
+    proximas->fimFila = (int*)alocarIndice(sizeof(int) * n);
+    proximas->disponivel = (unsigned char*)alocarIndice(n);
+    for (int id = 0; id < quantidade; id++) proximas->disponivel[id] = mapa->comodos[id].pista != SEM_PISTA;
+
+    int* ordem = (int*)alocarIndice(sizeof(int) * n);
+    int* veioDe = (int*)alocarIndice(sizeof(int) * n);
+    int* tamanho = (int*)alocarIndice(sizeof(int) * n);
+    int* pendentes = (int*)alocarIndice(sizeof(int) * 2 * n); // Pares (cômodo da componente, centróide acima)
+    unsigned char* removido = (unsigned char*)calloc(n, 1);
+    size_t capacidadeFila = n, usados = 0;
+    proximas->fila = (int*)alocarIndice(sizeof(int) * capacidadeFila);
+    if (removido == NULL) {
+        perror("Erro na alocação de memória para o mapa indexado");
+        exit(EXIT_FAILURE);
+    }
+
+    int topo = 0;
+    pendentes[topo++] = 0;
+    pendentes[topo++] = -1;
+    while (topo > 0) {
+        int acima = pendentes[--topo];
+        int inicio = pendentes[--topo];
+
+        // 1. Tamanhos das subárvores da componente (de trás para frente na busca)
+        int total = percorrerComponente(mapa, removido, inicio, ordem, veioDe);
+        for (int i = 0; i < total; i++) tamanho[ordem[i]] = 1;
+        for (int i = total - 1; i > 0; i--) tamanho[veioDe[ordem[i]]] += tamanho[ordem[i]];
+
+        // 2. Centróide: desce pelo filho que tem mais da metade da componente
+        int centroide = inicio, desceu = 1;
+        while (desceu) {
+            desceu = 0;
+            int vizinhos[3] = { mapa->pai[centroide], mapa->comodos[centroide].esquerda, mapa->comodos[centroide].direita };
+            for (int v = 0; v < 3; v++) {
+                int vizinho = vizinhos[v];
+                if (vizinho >= 0 && !removido[vizinho] && veioDe[vizinho] == centroide && tamanho[vizinho] * 2 > total) {
+                    centroide = vizinho;
+                    desceu = 1;
+                    break;
+                }
+            }
+        }
+        removido[centroide] = 1;
+        proximas->paiCentroide[centroide] = acima;
+
+        // 3. Fila do centróide: pistas da componente, da mais próxima à mais distante
+        total = percorrerComponente(mapa, removido, centroide, ordem, veioDe);
+        if (usados + (size_t)total > capacidadeFila) {
+            while (usados + (size_t)total > capacidadeFila) capacidadeFila *= 2;
+            proximas->fila = (int*)realloc(proximas->fila, sizeof(int) * capacidadeFila);
+            if (proximas->fila == NULL) {
+                perror("Erro na alocação de memória para o mapa indexado");
+                exit(EXIT_FAILURE);
+            }
+        }
+        proximas->cursor[centroide] = (int)usados;
+        for (int i = 0; i < total; i++) {
+            if (proximas->disponivel[ordem[i]]) proximas->fila[usados++] = ordem[i];
+        }
+        proximas->fimFila[centroide] = (int)usados;
+
+        // 4. O que sobra da componente se divide em até três componentes menores
+        int vizinhos[3] = { mapa->pai[centroide], mapa->comodos[centroide].esquerda, mapa->comodos[centroide].direita };
+        for (int v = 0; v < 3; v++) {
+            if (vizinhos[v] < 0 || removido[vizinhos[v]]) continue;
+            pendentes[topo++] = vizinhos[v];
+            pendentes[topo++] = centroide;
+        }
+    }
+
+    free(ordem);
+    free(veioDe);
+    free(tamanho);
+    free(pendentes);
+    free(removido);
+}
+
+// Pista ainda não coletada mais próxima de 'origem' (-1 se não houver).
+// Sobe pelos até log2(n) + 1 centróides de 'origem' com distâncias em O(1)
+// pelo LCA; cada fila descarta de vez as pistas já coletadas do seu início, e
+// cada posição é descartada uma única vez. Custo amortizado: O(log n).
+int pistaMaisProxima(PistasProximas* proximas, const MapaIndexado* mapa, int origem, int* distancia) {
+    int melhor = -1, menor = INT_MAX;
+    for (int c = origem; c >= 0; c = proximas->paiCentroide[c]) {
+        int ateCentroide = distanciaComodos(mapa, origem, c);
+        if (ateCentroide >= menor) continue;
+        while (proximas->cursor[c] < proximas->fimFila[c] && !proximas->disponivel[proximas->fila[proximas->cursor[c]]]) {
+            proximas->cursor[c]++;
+        }
+        if (proximas->cursor[c] == proximas->fimFila[c]) continue;
+        int pista = proximas->fila[proximas->cursor[c]];
+        int total = ateCentroide + distanciaComodos(mapa, c, pista);
+        if (total < menor) {
+            menor = total;
+            melhor = pista;
+        }
+    }
+    if (distancia != NULL) *distancia = melhor >= 0 ? menor : -1;
+    return melhor;
+}
+
+// Registra a coleta da pista de um cômodo em O(1)
+void coletarPistaProxima(PistasProximas* proximas, int comodo) {
+    proximas->disponivel[comodo] = 0;
+}
+
+void liberarPistasProximas(PistasProximas* proximas) {
+    free(proximas->paiCentroide);
+    free(proximas->cursor);
+    free(proximas->fimFila);
+    free(proximas->fila);
+    free(proximas->disponivel);
+    memset(proximas, 0, sizeof(*proximas));
+}
+
+void liberarMapaIndexado(MapaIndexado* mapa) {
+    free(mapa->bloco);
+    memset(mapa, 0, sizeof(*mapa));
+}
+
+// Imprime a rota entre dois cômodos do mapa de demonstração
+int mostrarRota(Comodo* mansao, const char* nomeOrigem, const char* nomeDestino) {
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+
+    int origem = buscarComodoPorNome(&mapa, nomeOrigem);
+    int destino = buscarComodoPorNome(&mapa, nomeDestino);
+    if (origem < 0 || destino < 0) {
+        printf("Cômodo não encontrado: %s\n", origem < 0 ? nomeOrigem : nomeDestino);
+        liberarMapaIndexado(&mapa);
+        return 1;
+    }
+
+    int* rota = (int*)alocarIndice(sizeof(int) * ((size_t)distanciaComodos(&mapa, origem, destino) + 1));
+    int tamanho = rotaEntreComodos(&mapa, origem, destino, rota);
+    printf("Rota de **%s** até **%s** (%d passagens):\n", nomeOrigem, nomeDestino, tamanho - 1);
+    for (int i = 0; i < tamanho; i++) {
+        printf("  %s %s\n", i == 0 ? "  " : "->", mapa.comodos[rota[i]].nome);
+    }
+    printf("Ancestral comum: %s\n", mapa.comodos[lcaComodos(&mapa, origem, destino)].nome);
+
+    PistasProximas proximas;
+    prepararPistasProximas(&proximas, &mapa);
+    int distancia;
+    int pista = pistaMaisProxima(&proximas, &mapa, origem, &distancia);
+    if (pista >= 0) {
+        printf("Pista não coletada mais próxima de %s: %s (%d passagens)\n",
+               nomeOrigem, mapa.comodos[pista].nome, distancia);
+    }
+    liberarPistasProximas(&proximas);
+
+    free(rota);
+    liberarMapaIndexado(&mapa);
+    return 0;
+}
+
+double segundosDesde(const struct timespec* inicio) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)(agora.tv_sec - inicio->tv_sec) + (double)(agora.tv_nsec - inicio->tv_nsec) / 1e9;
+}
+
+// Mede o pré-processamento e as consultas numa mansão gerada com 'quantidade' cômodos
+int medirConsultasDeRota(int quantidade) {
+    if (quantidade <= 0) {
+        printf("Uso: ./mestre --medir-rotas <cômodos>  (cômodos > 0)\n");
+        return 1;
+    }
+    struct timespec inicio;
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = gerarMansao(quantidade, 12345u, &armazem);
+
+    MapaIndexado mapa;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    indexarMapa(&mapa, mansao);
+    double tempoIndexacao = segundosDesde(&inicio);
+
+    int maiorProfundidade = 0;
+    for (int i = 0; i < mapa.quantidade; i++) {
+        if (mapa.profundidade[i] > maiorProfundidade) maiorProfundidade = mapa.profundidade[i];
+    }
+    int* rota = (int*)alocarIndice(sizeof(int) * (2 * (size_t)maiorProfundidade + 1));
+
+    const int consultas = 1000000;
+    unsigned int estado = 777u;
+    long long somaDistancias = 0;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (int i = 0; i < consultas; i++) {
+        int a = (int)(proximoAleatorio(&estado) % (unsigned int)mapa.quantidade);
+        int b = (int)(proximoAleatorio(&estado) % (unsigned int)mapa.quantidade);
+        somaDistancias += distanciaComodos(&mapa, a, b);
+    }
+    double tempoLca = segundosDesde(&inicio);
+
+    // Confere uma rota contra a definição: passos consecutivos são pai/filho
+    int tamanho = rotaEntreComodos(&mapa, mapa.quantidade - 1, mapa.quantidade / 2, rota);
+    for (int i = 1; i < tamanho; i++) {
+        if (mapa.pai[rota[i]] != rota[i - 1] && mapa.pai[rota[i - 1]] != rota[i]) {
+            printf("Rota inválida entre %d e %d\n", rota[i - 1], rota[i]);
+            free(rota);
+            liberarMapaIndexado(&mapa);
+            liberarMapa(mansao);
+            liberarArmazem(&armazem);
+            return 1;
+        }
+    }
+
+    // Pistas mais próximas: o jogador segue a dica, coleta a pista e pede a
+    // próxima de um cômodo sorteado. Algumas respostas são conferidas contra a
+    // varredura de todos os cômodos.
+    PistasProximas proximas;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    prepararPistasProximas(&proximas, &mapa);
+    double tempoPreparo = segundosDesde(&inicio);
+
+    const int coletas = 100000;
+    int origem = 0, coletadas = 0, erro = 0;
+    double tempoColetas = 0;
+    while (coletadas < coletas) {
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        int distancia;
+        int pista = pistaMaisProxima(&proximas, &mapa, origem, &distancia);
+        if (pista >= 0) coletarPistaProxima(&proximas, pista);
+        tempoColetas += segundosDesde(&inicio);
+        if (coletadas % (coletas / 10) == 0) {
+            int esperada = INT_MAX;
+            for (int id = 0; id < mapa.quantidade; id++) {
+                int d = distanciaComodos(&mapa, origem, id);
+                if ((proximas.disponivel[id] || id == pista) && d < esperada) esperada = d;
+            }
+            if (pista >= 0 ? distancia != esperada : esperada != INT_MAX) {
+                printf("Pista mais próxima errada a partir de %d: %d passagens, esperado %d\n", origem, distancia, esperada);
+                erro = 1;
+            }
+        }
+        if (pista < 0 || erro) break;
+        coletadas++;
+        origem = (int)(proximoAleatorio(&estado) % (unsigned int)mapa.quantidade);
+    }
+
+    printf("Cômodos: %d | profundidade máxima: %d\n", mapa.quantidade, maiorProfundidade);
+    printf("Indexação (pais, profundidades, tabela esparsa): %.3f s\n", tempoIndexacao);
+    printf("%d consultas de LCA/distância: %.3f s (%.1f ns por consulta, soma %lld)\n",
+           consultas, tempoLca, tempoLca * 1e9 / consultas, somaDistancias);
+    printf("Pistas mais próximas: preparo %.3f s | %d consultas com coleta: %.3f s (%.2f µs por consulta)\n",
+           tempoPreparo, coletadas, tempoColetas, coletadas > 0 ? tempoColetas * 1e6 / coletadas : 0.0);
+
+    free(rota);
+    liberarPistasProximas(&proximas);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return erro;
+}
+
+// -------------------------------------------------------------------
+// 9. MANSÃO COMO GRAFO (CSR)
+// -------------------------------------------------------------------
+
+// Mansão genérica: grafo dirigido em formato CSR (compressed sparse row).
+// As passagens que saem da sala 's' ficam em destino[inicio[s] .. inicio[s+1]-1].
+// Nomes e suspeitos ficam num único bloco, referenciados por deslocamento; as
+// pistas são ids do armazém de pistas usado na construção.
+typedef struct GrafoMansao {
+    int quantidade;           // número de salas
+    int passagens;            // número de arestas dirigidas
+    int* inicio;              // quantidade + 1 posições
+    int* destino;             // passagens posições
+    char* rotulo;             // rótulo de cada passagem ('E', 'D' na importação da árvore)
+    char* textos;             // nomes e suspeitos terminados em '\0'
+    int* nome;                // deslocamento em 'textos'
+    int* pista;               // id no armazém de pistas (SEM_PISTA se não houver)
+    int* suspeito;            // deslocamento em 'textos'
+    unsigned char* pistaColetada;
+} GrafoMansao;
+
+// Acumula salas e passagens em qualquer ordem; 'finalizarGrafo' gera o CSR
+typedef struct ConstrutorGrafo {
+    int quantidade, capacidadeSalas;
+    int* nome;
+    int* pista;
+    int* suspeito;
+    unsigned char* pistaColetada;
+    int passagens, capacidadePassagens;
+    int* origem;
+    int* destino;
+    char* rotulo;
+    char* textos;
+    size_t usadoTextos, capacidadeTextos;
+} ConstrutorGrafo;
+
+void* realocarGrafo(void* bloco, size_t tamanho) {
+    void* novo = realloc(bloco, tamanho);
+    if (novo == NULL) {
+        perror("Erro na alocação de memória para o grafo da mansão");
+        exit(EXIT_FAILURE);
+    }
+    return novo;
+}
+
+void inicializarConstrutor(ConstrutorGrafo* construtor) {
+    memset(construtor, 0, sizeof(*construtor));
+}
+
+int guardarTexto(ConstrutorGrafo* construtor, const char* texto) {
+    size_t tamanho = strlen(texto) + 1;
+    if (construtor->usadoTextos + tamanho > construtor->capacidadeTextos) {
+        size_t nova = construtor->capacidadeTextos ? construtor->capacidadeTextos * 2 : 4096;
+        while (nova < construtor->usadoTextos + tamanho) nova *= 2;
+        construtor->textos = (char*)realocarGrafo(construtor->textos, nova);
+        construtor->capacidadeTextos = nova;
+    }
+    int deslocamento = (int)construtor->usadoTextos;
+    memcpy(construtor->textos + deslocamento, texto, tamanho);
+    construtor->usadoTextos += tamanho;
+    return deslocamento;
+}
+
+// Adiciona uma sala e retorna seu índice
+int adicionarSala(ConstrutorGrafo* construtor, const char* nome, int pista,
+                  const char* suspeito, int pistaColetada) {
+    if (construtor->quantidade == construtor->capacidadeSalas) {
+        int nova = construtor->capacidadeSalas ? construtor->capacidadeSalas * 2 : 64;
+        construtor->nome = (int*)realocarGrafo(construtor->nome, sizeof(int) * (size_t)nova);
+        construtor->pista = (int*)realocarGrafo(construtor->pista, sizeof(int) * (size_t)nova);
+        construtor->suspeito = (int*)realocarGrafo(construtor->suspeito, sizeof(int) * (size_t)nova);
+        construtor->pistaColetada = (unsigned char*)realocarGrafo(construtor->pistaColetada, (size_t)nova);
+        construtor->capacidadeSalas = nova;
+    }
+    int indice = construtor->quantidade++;
+    construtor->nome[indice] = guardarTexto(construtor, nome);
+    construtor->pista[indice] = pista;
+    construtor->suspeito[indice] = guardarTexto(construtor, suspeito);
+    construtor->pistaColetada[indice] = (unsigned char)(pistaColetada != 0);
+    return indice;
+}
+
+void adicionarPassagem(ConstrutorGrafo* construtor, int origem, int destino, char rotulo) {
+    if (construtor->passagens == construtor->capacidadePassagens) {
+        int nova = construtor->capacidadePassagens ? construtor->capacidadePassagens * 2 : 64;
+        construtor->origem = (int*)realocarGrafo(construtor->origem, sizeof(int) * (size_t)nova);
+        construtor->destino = (int*)realocarGrafo(construtor->destino, sizeof(int) * (size_t)nova);
+        construtor->rotulo = (char*)realocarGrafo(construtor->rotulo, (size_t)nova);
+        construtor->capacidadePassagens = nova;
+    }
+    int indice = construtor->passagens++;
+    construtor->origem[indice] = origem;
+    construtor->destino[indice] = destino;
+    construtor->rotulo[indice] = rotulo;
+}
+
+// Converte o construtor em CSR (ordenação por contagem, estável: as passagens
+// de cada sala mantêm a ordem de inserção). O construtor é esvaziado.
+void finalizarGrafo(ConstrutorGrafo* construtor, GrafoMansao* grafo) {
+    int n = construtor->quantidade;
+    int m = construtor->passagens;
+
+    grafo->quantidade = n;
+    grafo->passagens = m;
+    grafo->inicio = (int*)calloc((size_t)n + 1, sizeof(int));
+    grafo->destino = (int*)malloc(sizeof(int) * ((size_t)m + 1));
+    grafo->rotulo = (char*)malloc((size_t)m + 1);
+    if (grafo->inicio == NULL || grafo->destino == NULL || grafo->rotulo == NULL) {
+        perror("Erro na alocação de memória para o grafo da mansão");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < m; i++) grafo->inicio[construtor->origem[i] + 1]++;
+    for (int s = 0; s < n; s++) grafo->inicio[s + 1] += grafo->inicio[s];
+    int* posicao = (int*)malloc(sizeof(int) * ((size_t)n + 1));
+    if (posicao == NULL) {
+        perror("Erro na alocação de memória para o grafo da mansão");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(posicao, grafo->inicio, sizeof(int) * ((size_t)n + 1));
+    for (int i = 0; i < m; i++) {
+        int p = posicao[construtor->origem[i]]++;
+        grafo->destino[p] = construtor->destino[i];
+        grafo->rotulo[p] = construtor->rotulo[i];
+    }
+    free(posicao);
+
+    // Os atributos passam para o grafo sem cópia
+    grafo->textos = construtor->textos;
+    grafo->nome = construtor->nome;
+    grafo->pista = construtor->pista;
+    grafo->suspeito = construtor->suspeito;
+    grafo->pistaColetada = construtor->pistaColetada;
+
+    free(construtor->origem);
+    free(construtor->destino);
+    free(construtor->rotulo);
+    inicializarConstrutor(construtor);
+}
+
+// Descarta um construtor que não será finalizado
+void descartarConstrutor(ConstrutorGrafo* construtor) {
+    free(construtor->nome);
+    free(construtor->pista);
+    free(construtor->suspeito);
+    free(construtor->pistaColetada);
+    free(construtor->origem);
+    free(construtor->destino);
+    free(construtor->rotulo);
+    free(construtor->textos);
+    inicializarConstrutor(construtor);
+}
+
+void liberarGrafo(GrafoMansao* grafo) {
+    free(grafo->inicio);
+    free(grafo->destino);
+    free(grafo->rotulo);
+    free(grafo->textos);
+    free(grafo->nome);
+    free(grafo->pista);
+    free(grafo->suspeito);
+    free(grafo->pistaColetada);
+    memset(grafo, 0, sizeof(*grafo));
+}
+
+static inline const char* nomeSala(const GrafoMansao* grafo, int sala) {
+    return grafo->textos + grafo->nome[sala];
+}
+
+static inline const char* suspeitoSala(const GrafoMansao* grafo, int sala) {
+    return grafo->textos + grafo->suspeito[sala];
+}
+
+// Importa a árvore de cômodos: salas em pré-ordem (a raiz é a sala 0), passagens
+// rotuladas 'E'/'D'. Os ids de pista são mantidos, então o grafo usa o mesmo
+// armazém da árvore. Retorna o índice da raiz no construtor (ou -1 se vazia).
+int importarArvore(ConstrutorGrafo* construtor, Comodo* raiz) {
+    if (raiz == NULL) return -1;
+    int base = construtor->quantidade;
+
+    // Pilha de pares (cômodo, sala do pai); o lado vem do rótulo empilhado
+    size_t capacidade = 64, topo = 0;
+    Comodo** pilhaComodo = (Comodo**)realocarGrafo(NULL, sizeof(Comodo*) * capacidade);
+    int* pilhaPai = (int*)realocarGrafo(NULL, sizeof(int) * capacidade);
+    char* pilhaLado = (char*)realocarGrafo(NULL, capacidade);
+
+    pilhaComodo[topo] = raiz;
+    pilhaPai[topo] = -1;
+    pilhaLado[topo++] = 0;
+    while (topo > 0) {
+        topo--;
+        Comodo* atual = pilhaComodo[topo];
+        int pai = pilhaPai[topo];
+        char lado = pilhaLado[topo];
+
+        int sala = adicionarSala(construtor, atual->nome, atual->pista,
+                                 atual->suspeito_associado, atual->pistaColetada);
+        if (pai >= 0) adicionarPassagem(construtor, pai, sala, lado);
+
+        if (topo + 2 > capacidade) {
+            capacidade *= 2;
+            pilhaComodo = (Comodo**)realocarGrafo(pilhaComodo, sizeof(Comodo*) * capacidade);
+            pilhaPai = (int*)realocarGrafo(pilhaPai, sizeof(int) * capacidade);
+            pilhaLado = (char*)realocarGrafo(pilhaLado, capacidade);
+        }
+        // Direita empilhada primeiro para que a esquerda seja visitada antes
+        if (atual->direita != NULL) {
+            pilhaComodo[topo] = atual->direita;
+            pilhaPai[topo] = sala;
+            pilhaLado[topo++] = 'D';
+        }
+        if (atual->esquerda != NULL) {
+            pilhaComodo[topo] = atual->esquerda;
+            pilhaPai[topo] = sala;
+            pilhaLado[topo++] = 'E';
+        }
+    }
+
+    free(pilhaComodo);
+    free(pilhaPai);
+    free(pilhaLado);
+    return base;
+}
+
+// Reconstrói a árvore de cômodos a partir do grafo (inverso de importarArvore).
+// Retorna NULL se o grafo não for uma árvore binária com passagens 'E'/'D'.
+Comodo* exportarArvore(const GrafoMansao* grafo, int raiz) {
+    if (raiz < 0 || raiz >= grafo->quantidade) return NULL;
+
+    Comodo** comodos = (Comodo**)calloc((size_t)grafo->quantidade, sizeof(Comodo*));
+    int* fila = (int*)malloc(sizeof(int) * (size_t)grafo->quantidade);
+    if (comodos == NULL || fila == NULL) {
+        perror("Erro na alocação de memória para a exportação do grafo");
+        exit(EXIT_FAILURE);
+    }
+
+    int valido = 1, cabeca = 0, cauda = 0;
+    comodos[raiz] = criarComodoEm(NULL, nomeSala(grafo, raiz), grafo->pista[raiz], suspeitoSala(grafo, raiz));
+    comodos[raiz]->pistaColetada = grafo->pistaColetada[raiz];
+    fila[cauda++] = raiz;
+    while (cabeca < cauda && valido) {
+        int sala = fila[cabeca++];
+        for (int p = grafo->inicio[sala]; p < grafo->inicio[sala + 1]; p++) {
+            int destino = grafo->destino[p];
+            char rotulo = grafo->rotulo[p];
+            Comodo** saida = rotulo == 'E' ? &comodos[sala]->esquerda
+                           : rotulo == 'D' ? &comodos[sala]->direita : NULL;
+            // Rótulo desconhecido, saída repetida ou sala já alcançada: não é árvore
+            if (saida == NULL || *saida != NULL || comodos[destino] != NULL) {
+                valido = 0;
+                break;
+            }
+            comodos[destino] = criarComodoEm(NULL, nomeSala(grafo, destino), grafo->pista[destino],
+                                             suspeitoSala(grafo, destino));
+            comodos[destino]->pistaColetada = grafo->pistaColetada[destino];
+            *saida = comodos[destino];
+            fila[cauda++] = destino;
+        }
+    }
+
+    Comodo* resultado = comodos[raiz];
+    if (!valido) {
+        for (int i = 0; i < grafo->quantidade; i++) free(comodos[i]);
+        resultado = NULL;
+    }
+    free(comodos);
+    free(fila);
+    return resultado;
+}
+
+// Compara duas árvores nó a nó (iterativo). Retorna 1 se forem idênticas.
+int arvoresIguais(const Comodo* a, const Comodo* b) {
+    size_t capacidade = 64, topo = 0;
+    const Comodo** pilha = (const Comodo**)realocarGrafo(NULL, sizeof(Comodo*) * capacidade);
+    int iguais = 1;
+
+    pilha[topo++] = a;
+    pilha[topo++] = b;
+    while (topo > 0 && iguais) {
+        const Comodo* y = pilha[--topo];
+        const Comodo* x = pilha[--topo];
+        if (x == NULL || y == NULL) {
+            iguais = (x == y);
+            continue;
+        }
+        iguais = strcmp(x->nome, y->nome) == 0 && x->pista == y->pista &&
+                 strcmp(x->suspeito_associado, y->suspeito_associado) == 0 &&
+                 x->pistaColetada == y->pistaColetada;
+        if (topo + 4 > capacidade) {
+            capacidade *= 2;
+            pilha = (const Comodo**)realocarGrafo((void*)pilha, sizeof(Comodo*) * capacidade);
+        }
+        pilha[topo++] = x->esquerda;
+        pilha[topo++] = y->esquerda;
+        pilha[topo++] = x->direita;
+        pilha[topo++] = y->direita;
+    }
+    free((void*)pilha);
+    return iguais;
+}
+
+// Carrega uma planta em texto. Linhas (campos separados por '|'):
+//   SALA nome|pista|suspeito
+//   PASSAGEM origem|destino|rotulo
+// Linhas vazias ou iniciadas por '#' são ignoradas. As pistas vão para 'armazem',
+// cujo dicionário é retreinado sobre o caso. Retorna 0 em caso de sucesso.
+typedef struct NomeIndice {
+    const char* nome;
+    int indice;
+} NomeIndice;
+
+int compararNomeIndice(const void* a, const void* b) {
+    return strcmp(((const NomeIndice*)a)->nome, ((const NomeIndice*)b)->nome);
+}
+
+int localizarSala(const NomeIndice* salas, int quantidade, const char* nome) {
+    NomeIndice chave = { nome, -1 };
+    const NomeIndice* achado = (const NomeIndice*)bsearch(&chave, salas, (size_t)quantidade,
+                                                           sizeof(NomeIndice), compararNomeIndice);
+    return achado != NULL ? achado->indice : -1;
+}
+
+// Separa 'linha' em até 'maximo' campos por '|' (modifica a linha)
+int separarCampos(char* linha, char** campos, int maximo) {
+    int total = 0;
+    char* inicio = linha;
+    while (total < maximo) {
+        char* separador = strchr(inicio, '|');
+        campos[total++] = inicio;
+        if (separador == NULL) break;
+        *separador = '\0';
+        inicio = separador + 1;
+    }
+    return total;
+}
+
+int carregarGrafo(const char* caminho, GrafoMansao* grafo, ArmazemPistas* armazem) {
+    FILE* arquivo = fopen(caminho, "r");
+    if (arquivo == NULL) {
+        perror("Erro ao abrir a planta da mansão");
+        return 1;
+    }
+
+    ConstrutorGrafo construtor;
+    inicializarConstrutor(&construtor);
+    // Passagens ficam pendentes até todas as salas serem conhecidas: origem e
+    // destino guardam o deslocamento do nome no bloco de textos de 'pendentes'
+    ConstrutorGrafo pendentes;
+    inicializarConstrutor(&pendentes);
+
+    char linha[512];
+    int numeroLinha = 0, erro = 0;
+    while (!erro && fgets(linha, sizeof(linha), arquivo) != NULL) {
+        numeroLinha++;
+        // Uma linha que não coube no buffer é erro, não duas linhas
+        if (strchr(linha, '\n') == NULL) {
+            int proximo = fgetc(arquivo);
+            if (proximo != '\n' && proximo != EOF) {
+                printf("Linha %d de %s passa de %zu bytes\n", numeroLinha, caminho, sizeof(linha) - 1);
+                erro = -1;
+                break;
+            }
+        }
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (linha[0] == '\0' || linha[0] == '#') continue;
+
+        char* campos[3] = { "", "", "" };
+        if (strncmp(linha, "SALA ", 5) == 0) {
+            separarCampos(linha + 5, campos, 3);
+            adicionarSala(&construtor, campos[0], registrarPista(armazem, campos[1]), campos[2], 0);
+        } else if (strncmp(linha, "PASSAGEM ", 9) == 0) {
+            if (separarCampos(linha + 9, campos, 3) < 2) erro = numeroLinha;
+            else adicionarPassagem(&pendentes, guardarTexto(&pendentes, campos[0]),
+                                   guardarTexto(&pendentes, campos[1]), campos[2][0]);
+        } else {
+            erro = numeroLinha;
+        }
+    }
+    fclose(arquivo);
+
+    NomeIndice* indice = (NomeIndice*)realocarGrafo(NULL, sizeof(NomeIndice) * ((size_t)construtor.quantidade + 1));
+    for (int i = 0; i < construtor.quantidade; i++) {
+        indice[i].nome = construtor.textos + construtor.nome[i];
+        indice[i].indice = i;
+    }
+    qsort(indice, (size_t)construtor.quantidade, sizeof(NomeIndice), compararNomeIndice);
+    for (int i = 1; i < construtor.quantidade && !erro; i++) {
+        if (strcmp(indice[i - 1].nome, indice[i].nome) == 0) {
+            printf("Sala duplicada em %s: %s\n", caminho, indice[i].nome);
+            erro = -1;
+        }
+    }
+
+    for (int i = 0; i < pendentes.passagens && !erro; i++) {
+        const char* nomeOrigem = pendentes.textos + pendentes.origem[i];
+        const char* nomeDestino = pendentes.textos + pendentes.destino[i];
+        int origem = localizarSala(indice, construtor.quantidade, nomeOrigem);
+        int destino = localizarSala(indice, construtor.quantidade, nomeDestino);
+        if (origem < 0 || destino < 0) {
+            printf("Passagem com sala desconhecida: %s -> %s\n", nomeOrigem, nomeDestino);
+            erro = -1;
+            break;
+        }
+        adicionarPassagem(&construtor, origem, destino, pendentes.rotulo[i] != '\0' ? pendentes.rotulo[i] : 'P');
+    }
+    free(indice);
+
+    descartarConstrutor(&pendentes);
+    finalizarGrafo(&construtor, grafo);
+    retreinarArmazem(armazem);
+
+    if (erro > 0) printf("Linha %d inválida em %s\n", erro, caminho);
+    if (erro != 0) {
+        liberarGrafo(grafo);
+        return 1;
+    }
+    return 0;
+}
+
+// Conjunto de bits com uma posição por sala
+typedef struct ConjuntoBits {
+    size_t palavras;
+    _Atomic uint64_t* bits;
+} ConjuntoBits;
+
+void criarConjuntoBits(ConjuntoBits* conjunto, int quantidade) {
+    conjunto->palavras = ((size_t)quantidade + 63) / 64;
+    conjunto->bits = (_Atomic uint64_t*)calloc(conjunto->palavras + 1, sizeof(uint64_t));
+    if (conjunto->bits == NULL) {
+        perror("Erro na alocação de memória para o conjunto de visitados");
+        exit(EXIT_FAILURE);
+    }
+}
+
+static inline int testarBit(const ConjuntoBits* conjunto, int i) {
+    uint64_t palavra = atomic_load_explicit(&conjunto->bits[i >> 6], memory_order_relaxed);
+    return (int)((palavra >> (i & 63)) & 1u);
+}
+
+// Marca o bit e retorna 1 se esta chamada foi a primeira a marcá-lo (seguro entre threads)
+static inline int marcarBit(ConjuntoBits* conjunto, int i) {
+    uint64_t mascara = (uint64_t)1 << (i & 63);
+    if (atomic_load_explicit(&conjunto->bits[i >> 6], memory_order_relaxed) & mascara) return 0;
+    uint64_t anterior = atomic_fetch_or_explicit(&conjunto->bits[i >> 6], mascara, memory_order_relaxed);
+    return (anterior & mascara) == 0;
+}
+
+void liberarConjuntoBits(ConjuntoBits* conjunto) {
+    free((void*)conjunto->bits);
+    conjunto->bits = NULL;
+}
+
+// Exploração interativa do grafo: sem recursão e segura com ciclos, pois as
+// salas visitadas ficam num conjunto de bits em vez da pilha de chamadas.
+void explorarGrafo(GrafoMansao* grafo, int inicio, PistaBST** raiz_pistas, TabelaHash* hash_suspeitos,
+                   const ArmazemPistas* armazem) {
+    if (inicio < 0 || inicio >= grafo->quantidade) return;
+
+    ConjuntoBits visitadas;
+    criarConjuntoBits(&visitadas, grafo->quantidade);
+    int atual = inicio;
+    char entrada[32];
+
+    printf("\n🚨 Você é o detetive e precisa encontrar o culpado! 🚨\n");
+
+    while (1) {
+        marcarBit(&visitadas, atual);
+        printf("\n========================================================\n");
+        printf("--- LOCAL ATUAL: **%s** ---\n", nomeSala(grafo, atual));
+
+        if (grafo->pista[atual] != SEM_PISTA && grafo->pistaColetada[atual] == 0) {
+            printf("\n🔎 **PISTA ENCONTRADA!**\n");
+            *raiz_pistas = inserirPistaBST(*raiz_pistas, armazem, grafo->pista[atual], suspeitoSala(grafo, atual));
+            incrementarContagemSuspeito(hash_suspeitos, suspeitoSala(grafo, atual));
+            grafo->pistaColetada[atual] = 1;
+            printf("  [Sistema]: Pista incrimina **%s** e foi registrada.\n", suspeitoSala(grafo, atual));
+        } else if (grafo->pista[atual] != SEM_PISTA) {
+            printf("ℹ️ Pista já coletada neste cômodo.\n");
+        } else {
+            printf("O cômodo parece limpo. Nenhuma pista visível aqui.\n");
+        }
+
+        int saidas = grafo->inicio[atual + 1] - grafo->inicio[atual];
+        if (saidas == 0) {
+            printf("\n🛑 **FIM DA LINHA!** A exploração da mansão terminou.\n");
+            break;
+        }
+
+        printf("\nPara onde você quer ir? (número da passagem ou F-Finalizar)\n");
+        for (int i = 0; i < saidas; i++) {
+            int destino = grafo->destino[grafo->inicio[atual] + i];
+            printf("   **[%d]** -> %s%s\n", i + 1, nomeSala(grafo, destino),
+                   testarBit(&visitadas, destino) ? " (já visitada)" : "");
+        }
+        printf("   **[F]inalizar** -> Encerrar a exploração e fazer a acusação.\n");
+
+        printf("Escolha: ");
+        if (scanf(" %31s", entrada) != 1) break;
+        if (toupper((unsigned char)entrada[0]) == 'F') {
+            printf("\nExploração encerrada. Preparando a acusação...\n");
+            break;
+        }
+        int escolha = atoi(entrada);
+        if (escolha < 1 || escolha > saidas) {
+            printf("Opção inválida.\n");
+            continue;
+        }
+        atual = grafo->destino[grafo->inicio[atual] + escolha - 1];
+    }
+
+    liberarConjuntoBits(&visitadas);
+}
+
+// Busca em largura sequencial: nível de cada sala a partir de 'inicio' (-1 se inalcançável)
+int alcanceSequencial(const GrafoMansao* grafo, int inicio, int* nivel) {
+    for (int i = 0; i < grafo->quantidade; i++) nivel[i] = -1;
+    if (inicio < 0 || inicio >= grafo->quantidade) return 0;
+    int* fila = (int*)realocarGrafo(NULL, sizeof(int) * ((size_t)grafo->quantidade + 1));
+    int cabeca = 0, cauda = 0;
+    nivel[inicio] = 0;
+    fila[cauda++] = inicio;
+    while (cabeca < cauda) {
+        int sala = fila[cabeca++];
+        for (int p = grafo->inicio[sala]; p < grafo->inicio[sala + 1]; p++) {
+            int destino = grafo->destino[p];
+            if (nivel[destino] < 0) {
+                nivel[destino] = nivel[sala] + 1;
+                fila[cauda++] = destino;
+            }
+        }
+    }
+    free(fila);
+    return cauda;
+}
+
+// Estado compartilhado da busca em largura paralela (síncrona por nível)
+typedef struct BuscaParalela {
+    const GrafoMansao* grafo;
+    int* nivel;
+    ConjuntoBits visitadas;
+    int* fronteira;
+    int* proxima;
+    int tamanhoFronteira;
+    _Atomic int tamanhoProxima;
+    _Atomic int cursor;       // próximo bloco da fronteira a ser processado
+    int profundidade;
+    int alcancadas;
+    pthread_barrier_t barreira;
+    // A barreira só é criada depois de saber quantas threads nasceram
+    pthread_mutex_t trava;
+    pthread_cond_t sinalLargada;
+    int largada;
+} BuscaParalela;
+
+#define BLOCO_BUSCA 256
+#define BUFFER_LOCAL_BUSCA 1024
+
+void* trabalharBuscaParalela(void* argumento) {
+    BuscaParalela* busca = (BuscaParalela*)argumento;
+    const GrafoMansao* grafo = busca->grafo;
+    int local[BUFFER_LOCAL_BUSCA];
+
+    pthread_mutex_lock(&busca->trava);
+    while (!busca->largada) pthread_cond_wait(&busca->sinalLargada, &busca->trava);
+    pthread_mutex_unlock(&busca->trava);
+
+    while (1) {
+        if (busca->tamanhoFronteira == 0) break;
+        int quantidadeLocal = 0;
+        int bloco;
+        // Cada thread pega blocos da fronteira até esgotá-la
+        while ((bloco = atomic_fetch_add(&busca->cursor, BLOCO_BUSCA)) < busca->tamanhoFronteira) {
+            int fim = bloco + BLOCO_BUSCA < busca->tamanhoFronteira ? bloco + BLOCO_BUSCA : busca->tamanhoFronteira;
+            for (int i = bloco; i < fim; i++) {
+                int sala = busca->fronteira[i];
+                for (int p = grafo->inicio[sala]; p < grafo->inicio[sala + 1]; p++) {
+                    int destino = grafo->destino[p];
+                    if (!marcarBit(&busca->visitadas, destino)) continue;
+                    busca->nivel[destino] = busca->profundidade + 1;
+                    local[quantidadeLocal++] = destino;
+                    if (quantidadeLocal == BUFFER_LOCAL_BUSCA) {
+                        int pos = atomic_fetch_add(&busca->tamanhoProxima, quantidadeLocal);
+                        memcpy(busca->proxima + pos, local, sizeof(int) * (size_t)quantidadeLocal);
+                        quantidadeLocal = 0;
+                    }
+                }
+            }
+        }
+        if (quantidadeLocal > 0) {
+            int pos = atomic_fetch_add(&busca->tamanhoProxima, quantidadeLocal);
+            memcpy(busca->proxima + pos, local, sizeof(int) * (size_t)quantidadeLocal);
+        }
+
+        // Uma única thread troca as fronteiras entre os níveis
+        if (pthread_barrier_wait(&busca->barreira) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            int* troca = busca->fronteira;
+            busca->fronteira = busca->proxima;
+            busca->proxima = troca;
+            busca->tamanhoFronteira = atomic_load(&busca->tamanhoProxima);
+            busca->alcancadas += busca->tamanhoFronteira;
+            atomic_store(&busca->tamanhoProxima, 0);
+            atomic_store(&busca->cursor, 0);
+            busca->profundidade++;
+        }
+        pthread_barrier_wait(&busca->barreira);
+    }
+    return NULL;
+}
+
+// Busca em largura paralela: mesmo resultado de alcanceSequencial
+int alcanceParalelo(const GrafoMansao* grafo, int inicio, int* nivel, int threads) {
+    if (threads < 1) threads = 1;
+    if (inicio < 0 || inicio >= grafo->quantidade) {
+        for (int i = 0; i < grafo->quantidade; i++) nivel[i] = -1;
+        return 0;
+    }
+    BuscaParalela busca;
+    busca.grafo = grafo;
+    busca.nivel = nivel;
+    criarConjuntoBits(&busca.visitadas, grafo->quantidade);
+    busca.fronteira = (int*)realocarGrafo(NULL, sizeof(int) * ((size_t)grafo->quantidade + 1));
+    busca.proxima = (int*)realocarGrafo(NULL, sizeof(int) * ((size_t)grafo->quantidade + 1));
+    for (int i = 0; i < grafo->quantidade; i++) nivel[i] = -1;
+
+    marcarBit(&busca.visitadas, inicio);
+    nivel[inicio] = 0;
+    busca.fronteira[0] = inicio;
+    busca.tamanhoFronteira = 1;
+    atomic_init(&busca.tamanhoProxima, 0);
+    atomic_init(&busca.cursor, 0);
+    busca.profundidade = 0;
+    busca.alcancadas = 1;
+    pthread_mutex_init(&busca.trava, NULL);
+    pthread_cond_init(&busca.sinalLargada, NULL);
+    busca.largada = 0;
+
+    // As threads criadas esperam a largada; se alguma não puder ser criada,
+    // a barreira conta só as que existem (no pior caso, busca na thread principal)
+    pthread_t* ids = (pthread_t*)realocarGrafo(NULL, sizeof(pthread_t) * (size_t)threads);
+    int criadas = 0;
+    while (criadas < threads - 1 &&
+           pthread_create(&ids[criadas], NULL, trabalharBuscaParalela, &busca) == 0) {
+        criadas++;
+    }
+    pthread_barrier_init(&busca.barreira, NULL, (unsigned int)criadas + 1);
+    pthread_mutex_lock(&busca.trava);
+    busca.largada = 1;
+    pthread_cond_broadcast(&busca.sinalLargada);
+    pthread_mutex_unlock(&busca.trava);
+    trabalharBuscaParalela(&busca);
+    for (int t = 0; t < criadas; t++) pthread_join(ids[t], NULL);
+
+    pthread_barrier_destroy(&busca.barreira);
+    pthread_cond_destroy(&busca.sinalLargada);
+    pthread_mutex_destroy(&busca.trava);
+    free(ids);
+    free(busca.fronteira);
+    free(busca.proxima);
+    liberarConjuntoBits(&busca.visitadas);
+    return busca.alcancadas;
+}
+
+int threadsDisponiveis(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+// Gera uma mansão grande, importa como grafo, confere a ida e volta sem perdas,
+// acrescenta corredores com ciclos e compara a busca em largura sequencial com a paralela
+int medirAlcance(int quantidade, int threads) {
+    if (quantidade <= 0) {
+        printf("Uso: ./mestre --medir-alcance <cômodos> [threads]  (cômodos > 0)\n");
+        return 1;
+    }
+    struct timespec inicio;
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = gerarMansao(quantidade, 424242u, &armazem);
+
+    ConstrutorGrafo construtor;
+    inicializarConstrutor(&construtor);
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int raiz = importarArvore(&construtor, mansao);
+    GrafoMansao arvore;
+    finalizarGrafo(&construtor, &arvore);
+    double tempoImportacao = segundosDesde(&inicio);
+
+    Comodo* copia = exportarArvore(&arvore, raiz);
+    int semPerdas = copia != NULL && arvoresIguais(mansao, copia);
+    liberarMapa(copia);
+    liberarGrafo(&arvore);
+    printf("Importação de %d cômodos: %.3f s | ida e volta sem perdas: %s\n",
+           quantidade, tempoImportacao, semPerdas ? "sim" : "NÃO");
+
+    // Mesma mansão com corredores extras (voltas e atalhos)
+    inicializarConstrutor(&construtor);
+    importarArvore(&construtor, mansao);
+    unsigned int estado = 99u;
+    for (int i = 0; i < quantidade; i++) {
+        int a = (int)(proximoAleatorio(&estado) % (unsigned int)quantidade);
+        int b = (int)(proximoAleatorio(&estado) % (unsigned int)quantidade);
+        adicionarPassagem(&construtor, a, b, 'P');
+    }
+    GrafoMansao grafo;
+    finalizarGrafo(&construtor, &grafo);
+    liberarMapa(mansao);
+
+    int* nivelSequencial = (int*)realocarGrafo(NULL, sizeof(int) * (size_t)grafo.quantidade);
+    int* nivelParalelo = (int*)realocarGrafo(NULL, sizeof(int) * (size_t)grafo.quantidade);
+
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int alcancadasSeq = alcanceSequencial(&grafo, 0, nivelSequencial);
+    double tempoSeq = segundosDesde(&inicio);
+
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int alcancadasPar = alcanceParalelo(&grafo, 0, nivelParalelo, threads);
+    double tempoPar = segundosDesde(&inicio);
+
+    int iguais = alcancadasSeq == alcancadasPar &&
+                 memcmp(nivelSequencial, nivelParalelo, sizeof(int) * (size_t)grafo.quantidade) == 0;
+    printf("Grafo: %d salas, %d passagens\n", grafo.quantidade, grafo.passagens);
+    printf("Busca sequencial: %d salas alcançáveis em %.3f s\n", alcancadasSeq, tempoSeq);
+    printf("Busca paralela (%d threads): %d salas alcançáveis em %.3f s | níveis iguais: %s\n",
+           threads, alcancadasPar, tempoPar, iguais ? "sim" : "NÃO");
+
+    free(nivelSequencial);
+    free(nivelParalelo);
+    liberarGrafo(&grafo);
+    liberarArmazem(&armazem);
+    return semPerdas && iguais ? 0 : 1;
+}
+
+// Joga numa planta carregada de arquivo (a primeira sala é a entrada)
+int jogarGrafo(const char* caminho) {
+    GrafoMansao grafo;
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    if (carregarGrafo(caminho, &grafo, &armazem) != 0) {
+        liberarArmazem(&armazem);
+        return 1;
+    }
+    if (grafo.quantidade == 0) {
+        printf("A planta não tem salas.\n");
+        liberarGrafo(&grafo);
+        liberarArmazem(&armazem);
+        return 1;
+    }
+
+    PistaBST* pistas_coletadas = NULL;
+    TabelaHash hash_suspeitos;
+    inicializarHash(&hash_suspeitos);
+
+    explorarGrafo(&grafo, 0, &pistas_coletadas, &hash_suspeitos, &armazem);
+    avaliarAcusacao(&hash_suspeitos);
+
+    printf("\n========================================================\n");
+    printf("           📋 RELATÓRIO COMPLETO DE INDÍCIOS 📋          \n");
+    printf("========================================================\n");
+    if (pistas_coletadas != NULL) exibirPistasEmOrdem(pistas_coletadas, &armazem);
+    else printf("Nenhuma pista foi coletada.\n");
+
+    liberarPistas(pistas_coletadas);
+    liberarHash(&hash_suspeitos);
+    liberarGrafo(&grafo);
+    liberarArmazem(&armazem);
+    return 0;
+}
+
+// -------------------------------------------------------------------
+// 10. CONSTRUÇÃO E LIBERAÇÃO EM PARALELO
+// -------------------------------------------------------------------
+
+// Trabalho de uma thread na geração paralela: uma subárvore inteira
+typedef struct TarefaGeracao {
+    int primeiro;
+    int quantidade;
+    unsigned int semente;
+    ArenaComodos* arena;     // NULL: cômodos no heap
+    const int* catalogo;     // Ids das pistas, já registradas no armazém
+    Comodo* raiz;
+    int emThread;            // 0: a tarefa rodou na thread principal
+} TarefaGeracao;
+
+void* executarGeracao(void* argumento) {
+    TarefaGeracao* tarefa = (TarefaGeracao*)argumento;
+    tarefa->raiz = gerarSubarvore(tarefa->primeiro, tarefa->quantidade, tarefa->semente, tarefa->arena,
+                                  tarefa->catalogo);
+    return NULL;
+}
+
+// Gera uma mansão com 'quantidade' cômodos usando 'threads' threads.
+// Os primeiros threads-1 cômodos formam um topo completo (filhos de i em 2i+1 e
+// 2i+2), cujas 'threads' saídas livres recebem uma subárvore gerada por thread.
+// Se 'arenas' não for NULL, a thread t aloca em arenas[t] (o topo usa arenas[0]).
+// O catálogo (registrarCatalogoGerado) vem pronto, pois o armazém não aceita
+// registros simultâneos. Se uma thread não puder ser criada, a subárvore dela
+// é gerada na thread principal.
+Comodo* gerarMansaoParalela(int quantidade, unsigned int semente, int threads, ArenaComodos* arenas,
+                            const int* catalogo) {
+    if (threads < 1) threads = 1;
+    if (quantidade < threads * 2) threads = 1;
+    if (threads == 1) return gerarSubarvore(0, quantidade, semente, arenas, catalogo);
+
+    int topo = threads - 1;
+    Comodo** comodosTopo = (Comodo**)malloc(sizeof(Comodo*) * (size_t)topo);
+    TarefaGeracao* tarefas = (TarefaGeracao*)malloc(sizeof(TarefaGeracao) * (size_t)threads);
+    pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)threads);
+    if (comodosTopo == NULL || tarefas == NULL || ids == NULL) {
+        perror("Erro na alocação de memória para a geração paralela");
+        exit(EXIT_FAILURE);
+    }
+
+    char nome[MAX_NOME];
+    for (int i = 0; i < topo; i++) {
+        snprintf(nome, sizeof(nome), "Cômodo %d", i);
+        comodosTopo[i] = criarComodoEm(arenas, nome, SEM_PISTA, "");
+        if (i > 0) {
+            if (i % 2 == 1) comodosTopo[(i - 1) / 2]->esquerda = comodosTopo[i];
+            else comodosTopo[(i - 1) / 2]->direita = comodosTopo[i];
+        }
+    }
+
+    int restante = quantidade - topo;
+    int primeiro = topo;
+    for (int t = 0; t < threads; t++) {
+        tarefas[t].quantidade = restante / threads + (t < restante % threads ? 1 : 0);
+        tarefas[t].primeiro = primeiro;
+        tarefas[t].semente = semente ^ (0x9e3779b9u * (unsigned int)(t + 1));
+        tarefas[t].arena = arenas != NULL ? &arenas[t] : NULL;
+        tarefas[t].catalogo = catalogo;
+        primeiro += tarefas[t].quantidade;
+        tarefas[t].emThread = t > 0 && pthread_create(&ids[t], NULL, executarGeracao, &tarefas[t]) == 0;
+        if (t > 0 && !tarefas[t].emThread) executarGeracao(&tarefas[t]);
+    }
+    executarGeracao(&tarefas[0]);
+    for (int t = 1; t < threads; t++) {
+        if (tarefas[t].emThread) pthread_join(ids[t], NULL);
+    }
+
+    // Saída livre j (topo <= j <= 2*topo) pertence ao cômodo (j-1)/2
+    for (int t = 0; t < threads; t++) {
+        int j = topo + t;
+        if (j % 2 == 1) comodosTopo[(j - 1) / 2]->esquerda = tarefas[t].raiz;
+        else comodosTopo[(j - 1) / 2]->direita = tarefas[t].raiz;
+    }
+
+    Comodo* raiz = comodosTopo[0];
+    free(comodosTopo);
+    free(tarefas);
+    free(ids);
+    return raiz;
+}
+
+// Fila de subárvores repartida entre as threads de liberação
+typedef struct TarefaLiberacao {
+    Comodo** subarvores;
+    int quantidade;
+    _Atomic int proxima;
+} TarefaLiberacao;
+
+void* executarLiberacao(void* argumento) {
+    TarefaLiberacao* tarefa = (TarefaLiberacao*)argumento;
+    int i;
+    while ((i = atomic_fetch_add(&tarefa->proxima, 1)) < tarefa->quantidade) {
+        liberarMapa(tarefa->subarvores[i]);
+    }
+    return NULL;
+}
+
+// Libera uma mansão do heap em paralelo: separa a árvore em várias subárvores
+// (percorrendo só o topo, em largura) e as distribui entre as threads.
+void liberarMapaParalelo(Comodo* raiz, int threads) {
+    if (raiz == NULL) return;
+    if (threads <= 1) {
+        liberarMapa(raiz);
+        return;
+    }
+
+    // Mais subárvores que threads equilibra a carga quando a árvore é irregular
+    int alvo = threads * 8;
+    Comodo** fronteira = (Comodo**)malloc(sizeof(Comodo*) * (size_t)(alvo * 2 + 2));
+    Comodo** topo = (Comodo**)malloc(sizeof(Comodo*) * (size_t)(alvo * 2 + 2));
+    if (fronteira == NULL || topo == NULL) {
+        // Sem memória para dividir o trabalho: liberação sequencial continua segura
+        free(fronteira);
+        free(topo);
+        liberarMapa(raiz);
+        return;
+    }
+
+    int cabeca = 0, cauda = 0, quantidadeTopo = 0;
+    fronteira[cauda++] = raiz;
+    // O topo também é limitado: numa cadeia degenerada a fronteira nunca cresce
+    while (cabeca < cauda && cauda - cabeca < alvo && quantidadeTopo < alvo) {
+        Comodo* atual = fronteira[cabeca++];
+        topo[quantidadeTopo++] = atual;
+        if (atual->esquerda != NULL) fronteira[cauda++] = atual->esquerda;
+        if (atual->direita != NULL) fronteira[cauda++] = atual->direita;
+        atual->esquerda = atual->direita = NULL;
+    }
+
+    TarefaLiberacao tarefa;
+    tarefa.subarvores = fronteira + cabeca;
+    tarefa.quantidade = cauda - cabeca;
+    atomic_init(&tarefa.proxima, 0);
+
+    pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)threads);
+    int criadas = 0;
+    if (ids != NULL) {
+        while (criadas < threads - 1 &&
+               pthread_create(&ids[criadas], NULL, executarLiberacao, &tarefa) == 0) {
+            criadas++;
+        }
+    }
+    executarLiberacao(&tarefa);
+    for (int t = 0; t < criadas; t++) pthread_join(ids[t], NULL);
+
+    for (int i = 0; i < quantidadeTopo; i++) free(topo[i]);
+    free(ids);
+    free(fronteira);
+    free(topo);
+}
+
+// Cadeia degenerada (cada cômodo só tem saída à esquerda), para testar a pilha
+Comodo* gerarCadeia(int quantidade) {
+    Comodo* raiz = NULL;
+    char nome[MAX_NOME];
+    for (int i = quantidade - 1; i >= 0; i--) {
+        snprintf(nome, sizeof(nome), "Corredor %d", i);
+        Comodo* novo = criarComodoEm(NULL, nome, SEM_PISTA, "");
+        novo->esquerda = raiz;
+        raiz = novo;
+    }
+    return raiz;
+}
+
+// Tempo de montagem e liberação em função do número de cômodos
+int medirMemoria(int maximo, int threads) {
+    struct timespec inicio;
+    ArenaComodos* arenas = (ArenaComodos*)malloc(sizeof(ArenaComodos) * (size_t)threads);
+    if (arenas == NULL) {
+        perror("Erro na alocação de memória para as arenas");
+        return 1;
+    }
+
+    printf("Threads: %d | tamanho do Comodo: %zu bytes\n", threads, sizeof(Comodo));
+    printf("%10s | %21s | %21s | %21s\n", "", "sequencial (heap)", "paralelo (heap)", "paralelo (arenas)");
+    printf("%11s | %10s %10s | %10s %10s | %10s %10s\n",
+           "cômodos", "montagem", "liberação", "montagem", "liberação", "montagem", "liberação");
+
+    // O catálogo de pistas é o mesmo em todas as rodadas: registrado uma vez,
+    // fora das medições, que ficam só com a montagem dos cômodos
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    int* catalogo = registrarCatalogoGerado(&armazem);
+
+    for (int quantidade = 1000; quantidade <= maximo; quantidade *= 10) {
+        double tempos[6];
+
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        Comodo* mansao = gerarSubarvore(0, quantidade, 2024u, NULL, catalogo);
+        tempos[0] = segundosDesde(&inicio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        liberarMapa(mansao);
+        tempos[1] = segundosDesde(&inicio);
+
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        mansao = gerarMansaoParalela(quantidade, 2024u, threads, NULL, catalogo);
+        tempos[2] = segundosDesde(&inicio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        liberarMapaParalelo(mansao, threads);
+        tempos[3] = segundosDesde(&inicio);
+
+        for (int t = 0; t < threads; t++) inicializarArena(&arenas[t]);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        mansao = gerarMansaoParalela(quantidade, 2024u, threads, arenas, catalogo);
+        tempos[4] = segundosDesde(&inicio);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        for (int t = 0; t < threads; t++) liberarArena(&arenas[t]);
+        tempos[5] = segundosDesde(&inicio);
+
+        printf("%10d | %9.4fs %9.4fs | %9.4fs %9.4fs | %9.4fs %9.4fs\n", quantidade,
+               tempos[0], tempos[1], tempos[2], tempos[3], tempos[4], tempos[5]);
+        if (quantidade > maximo / 10) break;
+    }
+    free(arenas);
+    free(catalogo);
+    liberarArmazem(&armazem);
+
+    // Uma recursão com um quadro por cômodo estouraria a pilha aqui
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    Comodo* cadeia = gerarCadeia(maximo);
+    liberarMapa(cadeia);
+    printf("Cadeia degenerada com %d cômodos montada e liberada em %.4f s\n", maximo, segundosDesde(&inicio));
+    return 0;
+}
+
+// -------------------------------------------------------------------
+// 11. PLACAR GLOBAL DE SUSPEITOS (SEM TRAVAS)
+// -------------------------------------------------------------------
+
+// Contagem de pistas por suspeito compartilhada entre todas as sessões.
+// A tabela tem tamanho fixo e endereçamento aberto: uma entrada, uma vez
+// publicada por CAS, nunca é removida, então a busca não precisa de trava.
+// Cada entrada tem um contador por fatia (uma linha de cache cada); a thread
+// incrementa a fatia da sua CPU e a leitura soma todas as fatias.
+#define CAPACIDADE_PLACAR 1024  // Potência de 2: máximo de suspeitos distintos
+#define FATIAS_PLACAR 16
+#define LINHA_CACHE 64
+
+typedef struct FatiaPlacar {
+    _Alignas(LINHA_CACHE) _Atomic long valor;
+} FatiaPlacar;
+
+typedef struct EntradaPlacar {
+    _Atomic(char*) suspeito;    // NULL = posição livre
+    FatiaPlacar fatias[FATIAS_PLACAR];
+} EntradaPlacar;
+
+typedef struct PlacarGlobal {
+    EntradaPlacar* entradas;
+    _Atomic int ocupadas;
+} PlacarGlobal;
+
+void inicializarPlacar(PlacarGlobal* placar) {
+    placar->entradas = (EntradaPlacar*)aligned_alloc(LINHA_CACHE, sizeof(EntradaPlacar) * CAPACIDADE_PLACAR);
+    if (placar->entradas == NULL) {
+        perror("Erro na alocação de memória para o placar global");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < CAPACIDADE_PLACAR; i++) {
+        atomic_init(&placar->entradas[i].suspeito, NULL);
+        for (int f = 0; f < FATIAS_PLACAR; f++) atomic_init(&placar->entradas[i].fatias[f].valor, 0);
+    }
+    atomic_init(&placar->ocupadas, 0);
+}
+
+void liberarPlacar(PlacarGlobal* placar) {
+    for (int i = 0; i < CAPACIDADE_PLACAR; i++) free(atomic_load(&placar->entradas[i].suspeito));
+    free(placar->entradas);
+    placar->entradas = NULL;
+}
+
+static unsigned int hashSuspeitoPlacar(const char* nome) {
+    unsigned int hash = 2166136261u; // FNV-1a
+    for (const unsigned char* p = (const unsigned char*)nome; *p != '\0'; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Localiza (e, se 'criar', insere) o suspeito. Retorna NULL se não existir ou se a tabela estiver cheia.
+EntradaPlacar* localizarNoPlacar(PlacarGlobal* placar, const char* nome, int criar) {
+    unsigned int pos = hashSuspeitoPlacar(nome) & (CAPACIDADE_PLACAR - 1);
+    char* copia = NULL;
+
+    for (int tentativas = 0; tentativas < CAPACIDADE_PLACAR; tentativas++) {
+        EntradaPlacar* entrada = &placar->entradas[pos];
+        char* atual = atomic_load_explicit(&entrada->suspeito, memory_order_acquire);
+        if (atual == NULL) {
+            if (!criar) return NULL;
+            if (copia == NULL) {
+                copia = strdup(nome);
+                if (copia == NULL) {
+                    perror("Erro na alocação de memória para o placar global");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            // Publica o nome; se outra thread ocupou a posição antes, 'atual' recebe o vencedor
+            if (atomic_compare_exchange_strong_explicit(&entrada->suspeito, &atual, copia,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                atomic_fetch_add_explicit(&placar->ocupadas, 1, memory_order_relaxed);
+                return entrada;
+            }
+        }
+        if (strcmp(atual, nome) == 0) {
+            free(copia);
+            return entrada;
+        }
+        pos = (pos + 1) & (CAPACIDADE_PLACAR - 1);
+    }
+    free(copia);
+    return NULL;
+}
+
+// Fatia usada pela thread atual: a CPU em que ela roda (ou um número fixo por thread)
+static inline int fatiaAtual(void) {
+    static _Atomic int proximaFatia = 0;
+    static _Thread_local int fatiaDaThread = -1;
+    int cpu = sched_getcpu();
+    if (cpu >= 0) return cpu % FATIAS_PLACAR;
+    if (fatiaDaThread < 0) fatiaDaThread = atomic_fetch_add(&proximaFatia, 1) % FATIAS_PLACAR;
+    return fatiaDaThread;
+}
+
+// Soma 'quantidade' pistas ao suspeito. Retorna 0, ou -1 se o placar estiver cheio.
+int incrementarPlacar(PlacarGlobal* placar, const char* nome, long quantidade) {
+    EntradaPlacar* entrada = localizarNoPlacar(placar, nome, 1);
+    if (entrada == NULL) return -1;
+    atomic_fetch_add_explicit(&entrada->fatias[fatiaAtual()].valor, quantidade, memory_order_relaxed);
+    return 0;
+}
+
+// Total de pistas do suspeito em todas as sessões (soma das fatias)
+long lerPlacar(PlacarGlobal* placar, const char* nome) {
+    EntradaPlacar* entrada = localizarNoPlacar(placar, nome, 0);
+    if (entrada == NULL) return 0;
+    long total = 0;
+    for (int f = 0; f < FATIAS_PLACAR; f++) {
+        total += atomic_load_explicit(&entrada->fatias[f].valor, memory_order_relaxed);
+    }
+    return total;
+}
+
+void exibirPlacar(PlacarGlobal* placar) {
+    for (int i = 0; i < CAPACIDADE_PLACAR; i++) {
+        const char* nome = atomic_load_explicit(&placar->entradas[i].suspeito, memory_order_acquire);
+        if (nome != NULL) printf("  %-20s %ld\n", nome, lerPlacar(placar, nome));
+    }
+}
+
+// Teste de estresse: várias threads incrementam e leem ao mesmo tempo
+#define SUSPEITOS_ESTRESSE 64
+
+typedef struct TarefaEstresse {
+    PlacarGlobal* placar;
+    int indice;
+    long incrementos;
+    long leiturasDecrescentes;  // Leituras que voltaram para trás (deve ficar 0)
+    int emThread;               // 0: sem thread disponível, rodou na principal
+} TarefaEstresse;
+
+void nomeSuspeitoEstresse(int i, char* nome, size_t tamanho) {
+    snprintf(nome, tamanho, "Suspeito %02d", i);
+}
+
+void* executarEstresse(void* argumento) {
+    TarefaEstresse* tarefa = (TarefaEstresse*)argumento;
+    long ultimaLeitura[SUSPEITOS_ESTRESSE] = { 0 };
+    char nome[MAX_SUSPEITO];
+    unsigned int estado = 0x9e3779b9u * (unsigned int)(tarefa->indice + 1);
+
+    for (long i = 0; i < tarefa->incrementos; i++) {
+        // O suspeito i % N recebe um incremento: os totais esperados são conhecidos
+        int suspeito = (int)((i + tarefa->indice) % SUSPEITOS_ESTRESSE);
+        nomeSuspeitoEstresse(suspeito, nome, sizeof(nome));
+        incrementarPlacar(tarefa->placar, nome, 1);
+
+        // Leitura concorrente de outro suspeito: um total nunca pode diminuir
+        if ((i & 7) == 0) {
+            int lido = (int)(proximoAleatorio(&estado) % SUSPEITOS_ESTRESSE);
+            nomeSuspeitoEstresse(lido, nome, sizeof(nome));
+            long valor = lerPlacar(tarefa->placar, nome);
+            if (valor < ultimaLeitura[lido]) tarefa->leiturasDecrescentes++;
+            ultimaLeitura[lido] = valor;
+        }
+    }
+    return NULL;
+}
+
+int estressarPlacar(int threads, long incrementosPorThread) {
+    if (threads < 1) threads = 1;
+    PlacarGlobal placar;
+    inicializarPlacar(&placar);
+
+    TarefaEstresse* tarefas = (TarefaEstresse*)calloc((size_t)threads, sizeof(TarefaEstresse));
+    pthread_t* ids = (pthread_t*)malloc(sizeof(pthread_t) * (size_t)threads);
+    if (tarefas == NULL || ids == NULL) {
+        perror("Erro na alocação de memória para o teste de estresse");
+        exit(EXIT_FAILURE);
+    }
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    for (int t = 0; t < threads; t++) {
+        tarefas[t].placar = &placar;
+        tarefas[t].indice = t;
+        tarefas[t].incrementos = incrementosPorThread;
+        tarefas[t].emThread = pthread_create(&ids[t], NULL, executarEstresse, &tarefas[t]) == 0;
+        if (!tarefas[t].emThread) executarEstresse(&tarefas[t]);
+    }
+    long decrescentes = 0;
+    for (int t = 0; t < threads; t++) {
+        if (tarefas[t].emThread) pthread_join(ids[t], NULL);
+        decrescentes += tarefas[t].leiturasDecrescentes;
+    }
+    double tempo = segundosDesde(&inicio);
+
+    // Confere a contagem exata de cada suspeito
+    int erros = 0;
+    long total = 0;
+    char nome[MAX_SUSPEITO];
+    for (int s = 0; s < SUSPEITOS_ESTRESSE; s++) {
+        long esperado = 0;
+        for (int t = 0; t < threads; t++) {
+            // Quantos i em [0, incrementos) têm (i + t) % N == s
+            long primeiro = ((s - t) % SUSPEITOS_ESTRESSE + SUSPEITOS_ESTRESSE) % SUSPEITOS_ESTRESSE;
+            if (primeiro < incrementosPorThread) esperado += (incrementosPorThread - 1 - primeiro) / SUSPEITOS_ESTRESSE + 1;
+        }
+        nomeSuspeitoEstresse(s, nome, sizeof(nome));
+        long obtido = lerPlacar(&placar, nome);
+        total += obtido;
+        if (obtido != esperado) {
+            printf("  %s: esperado %ld, obtido %ld\n", nome, esperado, obtido);
+            erros++;
+        }
+    }
+
+    long operacoes = (long)threads * incrementosPorThread;
+    printf("Threads: %d | incrementos: %ld | suspeitos: %d (%d no placar)\n", threads, operacoes,
+           SUSPEITOS_ESTRESSE, atomic_load(&placar.ocupadas));
+    printf("Tempo: %.3f s (%.1f milhões de incrementos/s)\n", tempo, (double)operacoes / tempo / 1e6);
+    printf("Total somado: %ld | contagens erradas: %d | leituras que diminuíram: %ld\n", total, erros, decrescentes);
+
+    free(tarefas);
+    free(ids);
+    liberarPlacar(&placar);
+    return erros == 0 && decrescentes == 0 && total == operacoes ? 0 : 1;
+}
+
+// -------------------------------------------------------------------
+// 12. MOTOR DE EXPLORAÇÃO SEM ALOCAÇÕES
+// -------------------------------------------------------------------
+
+// Tudo o que uma exploração consulta é pré-calculado uma vez por mansão
+// (somente leitura, compartilhável entre sessões). Uma sessão é dimensionada
+// pelo total de pistas da mansão ao ser criada; daí em diante, andar, coletar,
+// acusar e listar pistas não alocam memória nem copiam texto: pistas e
+// suspeitos são referenciados pelo id do cômodo.
+typedef struct MotorExploracao {
+    const MapaIndexado* mapa;     // Navegação: esquerda/direita por id
+    int quantidade;
+    const unsigned char* temPista; // Flag pré-calculada por cômodo
+    const int* indicePista;       // Índice entre os cômodos com pista (-1 sem pista)
+    const int* ordemPista;        // Posição do texto entre os textos distintos, em ordem alfabética (-1 sem pista)
+    const int* suspeitoDe;        // Índice do suspeito (-1 sem pista)
+    int totalPistas;
+    int pistasDistintas;          // Textos distintos: cômodos podem repetir a mesma pista
+    int suspeitos;
+    const char* const* nomeSuspeito; // Em ordem alfabética; aponta para o texto de um cômodo
+    void* bloco;                  // Memória única dos vetores acima (NULL numa tabela gerada)
+} MotorExploracao;
+
+typedef struct SessaoExploracao {
+    int atual;                    // Id do cômodo no mapa indexado
+    int coletadas;
+    unsigned char* coletada;      // Por cômodo com pista (indicePista)
+    int* primeiroComodo;          // Por texto distinto: cômodo que o coletou primeiro (-1 nenhum)
+    int* ordemDaColeta;           // Cômodos na ordem em que as pistas foram coletadas
+    int* contagem;                // Pistas por suspeito
+} SessaoExploracao;
+
+typedef struct ContextoOrdenacao {
+    const MapaIndexado* mapa;
+    const ArmazemPistas* armazem;
+} ContextoOrdenacao;
+
+// Ordem alfabética do texto da pista (empate: id do cômodo)
+static int compararPistasDosComodos(const void* a, const void* b, void* dados) {
+    const ContextoOrdenacao* contexto = (const ContextoOrdenacao*)dados;
+    int x = *(const int*)a, y = *(const int*)b;
+    int comparacao = compararPistas(contexto->armazem, contexto->mapa->comodos[x].pista, contexto->mapa->comodos[y].pista);
+    return comparacao != 0 ? comparacao : (x > y) - (x < y);
+}
+
+static int compararSuspeitosDosComodos(const void* a, const void* b, void* dados) {
+    const ContextoOrdenacao* contexto = (const ContextoOrdenacao*)dados;
+    return strcmp(contexto->mapa->comodos[*(const int*)a].suspeito_associado,
+                  contexto->mapa->comodos[*(const int*)b].suspeito_associado);
+}
+
+// Pré-calcula flags, ordem alfabética das pistas e índices de suspeitos. O(n log n).
+void prepararMotor(MotorExploracao* motor, const MapaIndexado* mapa, const ArmazemPistas* armazem) {
+    memset(motor, 0, sizeof(*motor));
+    motor->mapa = mapa;
+    motor->quantidade = mapa->quantidade;
+    int total = 0;
+    for (int id = 0; id < mapa->quantidade; id++) total += mapa->comodos[id].pista != SEM_PISTA;
+
+    // Um único bloco: os nomes (alinhados como ponteiros), os vetores de int e as flags
+    size_t n = (size_t)mapa->quantidade;
+    size_t pistas = (size_t)(total > 0 ? total : 1);
+    const char** nomeSuspeito = (const char**)alocarIndice(sizeof(char*) * pistas + sizeof(int) * 3 * n + n);
+    int* indicePista = (int*)(nomeSuspeito + pistas);
+    int* ordemPista = indicePista + n;
+    int* suspeitoDe = ordemPista + n;
+    unsigned char* temPista = (unsigned char*)(suspeitoDe + n);
+    motor->temPista = temPista;
+    motor->indicePista = indicePista;
+    motor->ordemPista = ordemPista;
+    motor->suspeitoDe = suspeitoDe;
+    motor->nomeSuspeito = nomeSuspeito;
+    motor->bloco = nomeSuspeito;
+    motor->totalPistas = total;
+
+    total = 0;
+    for (int id = 0; id < mapa->quantidade; id++) {
+        temPista[id] = mapa->comodos[id].pista != SEM_PISTA;
+        indicePista[id] = temPista[id] ? total++ : -1;
+        ordemPista[id] = -1;
+        suspeitoDe[id] = -1;
+    }
+
+    int* comodos = (int*)alocarIndice(sizeof(int) * pistas);
+    int k = 0;
+    for (int id = 0; id < mapa->quantidade; id++) {
+        if (temPista[id]) comodos[k++] = id;
+    }
+    ContextoOrdenacao contexto = { mapa, armazem };
+
+    // 1. Ordem alfabética dos textos distintos: a listagem vira uma varredura,
+    // e cômodos com o mesmo texto dividem a posição (como na BST, sem repetir)
+    qsort_r(comodos, (size_t)total, sizeof(int), compararPistasDosComodos, &contexto);
+    for (int i = 0; i < total; i++) {
+        if (i == 0 || compararPistas(armazem, mapa->comodos[comodos[i - 1]].pista, mapa->comodos[comodos[i]].pista) != 0) {
+            motor->pistasDistintas++;
+        }
+        ordemPista[comodos[i]] = motor->pistasDistintas - 1;
+    }
+
+    // 2. Suspeitos distintos, em ordem alfabética (acusação por busca binária)
+    qsort_r(comodos, (size_t)total, sizeof(int), compararSuspeitosDosComodos, &contexto);
+    for (int i = 0; i < total; i++) {
+        const char* nome = mapa->comodos[comodos[i]].suspeito_associado;
+        if (motor->suspeitos == 0 || strcmp(nomeSuspeito[motor->suspeitos - 1], nome) != 0) {
+            nomeSuspeito[motor->suspeitos++] = nome;
+        }
+        suspeitoDe[comodos[i]] = motor->suspeitos - 1;
+    }
+    free(comodos);
+}
+
+void liberarMotor(MotorExploracao* motor) {
+    free(motor->bloco);
+    memset(motor, 0, sizeof(*motor));
+}
+
+// Única alocação da sessão: dimensionada pelo motor, reaproveitada entre partidas
+void criarSessaoExploracao(SessaoExploracao* sessao, const MotorExploracao* motor) {
+    size_t pistas = (size_t)(motor->totalPistas > 0 ? motor->totalPistas : 1);
+    sessao->coletada = (unsigned char*)calloc(pistas, 1);
+    sessao->primeiroComodo = (int*)malloc(sizeof(int) * (size_t)(motor->pistasDistintas > 0 ? motor->pistasDistintas : 1));
+    sessao->ordemDaColeta = (int*)malloc(sizeof(int) * pistas);
+    sessao->contagem = (int*)calloc((size_t)(motor->suspeitos > 0 ? motor->suspeitos : 1), sizeof(int));
+    if (sessao->coletada == NULL || sessao->primeiroComodo == NULL || sessao->ordemDaColeta == NULL || sessao->contagem == NULL) {
+        perror("Erro na alocação de memória para a sessão de exploração");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < motor->pistasDistintas; i++) sessao->primeiroComodo[i] = -1;
+    sessao->atual = 0;
+    sessao->coletadas = 0;
+}
+
+// Volta ao Hall de Entrada com a sessão vazia, sem alocar. Desfaz só as
+// pistas coletadas: O(pistas da partida), não O(pistas da mansão).
+void reiniciarSessaoExploracao(SessaoExploracao* sessao, const MotorExploracao* motor) {
+    for (int i = 0; i < sessao->coletadas; i++) {
+        int comodo = sessao->ordemDaColeta[i];
+        sessao->coletada[motor->indicePista[comodo]] = 0;
+        sessao->primeiroComodo[motor->ordemPista[comodo]] = -1;
+    }
+    memset(sessao->contagem, 0, sizeof(int) * (size_t)motor->suspeitos);
+    sessao->atual = 0;
+    sessao->coletadas = 0;
+}
+
+void liberarSessaoExploracao(SessaoExploracao* sessao) {
+    free(sessao->coletada);
+    free(sessao->primeiroComodo);
+    free(sessao->ordemDaColeta);
+    free(sessao->contagem);
+    memset(sessao, 0, sizeof(*sessao));
+}
+
+// Entra no cômodo e coleta sua pista; retorna 1 se a pista do cômodo é nova
+// nesta sessão. A contagem é por cômodo, como na Hash; a listagem guarda só
+// o primeiro cômodo de cada texto, como a BST guarda o primeiro suspeito.
+static inline int entrarComodo(const MotorExploracao* motor, SessaoExploracao* sessao, int comodo) {
+    sessao->atual = comodo;
+    if (!motor->temPista[comodo]) return 0;
+    int indice = motor->indicePista[comodo];
+    if (sessao->coletada[indice]) return 0;
+    sessao->coletada[indice] = 1;
+    sessao->contagem[motor->suspeitoDe[comodo]]++;
+    sessao->ordemDaColeta[sessao->coletadas++] = comodo;
+    int* primeiro = &sessao->primeiroComodo[motor->ordemPista[comodo]];
+    if (*primeiro < 0) *primeiro = comodo;
+    return 1;
+}
+
+// Pistas coletadas contra o suspeito (busca binária nos nomes, sem cópia)
+int pistasContraSuspeito(const MotorExploracao* motor, const SessaoExploracao* sessao, const char* nome) {
+    int baixo = 0, alto = motor->suspeitos - 1;
+    while (baixo <= alto) {
+        int meio = (baixo + alto) / 2;
+        int comparacao = strcmp(motor->nomeSuspeito[meio], nome);
+        if (comparacao == 0) return sessao->contagem[meio];
+        if (comparacao < 0) baixo = meio + 1;
+        else alto = meio - 1;
+    }
+    return 0;
+}
+
+// Equivalente a exibirPistasEmOrdem: varre a ordem alfabética pré-calculada
+void exibirPistasSessao(const MotorExploracao* motor, const SessaoExploracao* sessao, const ArmazemPistas* armazem) {
+    for (int i = 0; i < motor->pistasDistintas; i++) {
+        if (sessao->primeiroComodo[i] < 0) continue;
+        const ComodoIndexado* comodo = &motor->mapa->comodos[sessao->primeiroComodo[i]];
+        printf(" -> Pista: \"");
+        imprimirPista(armazem, comodo->pista, stdout);
+        printf("\" | Suspeito Associado: %s\n", comodo->suspeito_associado);
+    }
+}
+
+// Contador de alocações, só num build de medição (gcc -DCONTAR_ALOCACOES ...):
+// as funções de alocação do programa passam a somar no contador da thread.
+// Substituir o malloc da libc no binário inteiro não é coisa para o jogo
+// normal, que sempre usa o alocador da libc sem intermediários. Alocações
+// feitas por dentro da própria libc (fopen, qsort...) não são contadas.
+#ifdef CONTAR_ALOCACOES
+#if !defined(__GLIBC__)
+#error "CONTAR_ALOCACOES requer glibc (__libc_malloc e afins)"
+#elif defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#error "CONTAR_ALOCACOES não combina com sanitizadores, que já substituem o malloc"
+#endif
+#define CONTADOR_ALOCACOES 1
+extern void* __libc_malloc(size_t tamanho);
+extern void* __libc_calloc(size_t quantidade, size_t tamanho);
+extern void* __libc_realloc(void* bloco, size_t tamanho);
+extern void* __libc_memalign(size_t alinhamento, size_t tamanho);
+
+static _Thread_local unsigned long alocacoesDaThread;
+
+void* malloc(size_t tamanho) {
+    alocacoesDaThread++;
+    return __libc_malloc(tamanho);
+}
+
+void* calloc(size_t quantidade, size_t tamanho) {
+    alocacoesDaThread++;
+    return __libc_calloc(quantidade, tamanho);
+}
+
+void* realloc(void* bloco, size_t tamanho) {
+    alocacoesDaThread++;
+    return __libc_realloc(bloco, tamanho);
+}
+
+void* aligned_alloc(size_t alinhamento, size_t tamanho) {
+    alocacoesDaThread++;
+    return __libc_memalign(alinhamento, tamanho);
+}
+
+int posix_memalign(void** bloco, size_t alinhamento, size_t tamanho) {
+    alocacoesDaThread++;
+    *bloco = __libc_memalign(alinhamento, tamanho);
+    return *bloco != NULL ? 0 : ENOMEM;
+}
+
+char* strdup(const char* texto) {
+    size_t tamanho = strlen(texto) + 1;
+    char* copia = (char*)malloc(tamanho);
+    if (copia != NULL) memcpy(copia, texto, tamanho);
+    return copia;
+}
+
+static unsigned long alocacoesAteAgora(void) {
+    return alocacoesDaThread;
+}
+#else
+#define CONTADOR_ALOCACOES 0
+static unsigned long alocacoesAteAgora(void) {
+    return 0;
+}
+#endif
+
+// Partidas aleatórias (raiz até uma folha) com o caminho antigo (BST + Hash)
+// e com o motor; conta as alocações de cada um. Falha se o motor alocar.
+// Sem o contador (build normal) não há o que medir: retorna 77, o código
+// de "teste pulado", em vez de imprimir contagens que seriam sempre zero.
+int medirAlocacoes(int quantidade, int partidas) {
+    if (!CONTADOR_ALOCACOES) {
+        printf("Contagem de alocações desligada neste build: compile com -DCONTAR_ALOCACOES para conferir.\n");
+        return 77;
+    }
+
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = gerarMansao(quantidade, 2024u, &armazem);
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    MotorExploracao motor;
+    prepararMotor(&motor, &mapa, &armazem);
+    SessaoExploracao sessao;
+    criarSessaoExploracao(&sessao, &motor);
+
+    // 1. Caminho antigo: um malloc por pista na BST e por suspeito novo na Hash
+    unsigned int estado = 99u;
+    long passosAntigo = 0, pistasAntigo = 0;
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    unsigned long antes = alocacoesAteAgora();
+    for (int p = 0; p < partidas; p++) {
+        PistaBST* pistas = NULL;
+        TabelaHash suspeitos;
+        inicializarHash(&suspeitos);
+        int atual = 0;
+        while (1) {
+            const ComodoIndexado* comodo = &mapa.comodos[atual];
+            passosAntigo++;
+            if (comodo->pista != SEM_PISTA) {
+                pistas = inserirPistaBST(pistas, &armazem, comodo->pista, comodo->suspeito_associado);
+                somarPistaSuspeito(&suspeitos, comodo->suspeito_associado);
+                pistasAntigo++;
+            }
+            int filhos[2] = { mapa.comodos[atual].esquerda, mapa.comodos[atual].direita };
+            if (filhos[0] < 0 && filhos[1] < 0) break;
+            int lado = (int)(proximoAleatorio(&estado) & 1);
+            atual = filhos[lado] >= 0 ? filhos[lado] : filhos[1 - lado];
+        }
+        liberarPistas(pistas);
+        liberarHash(&suspeitos);
+    }
+    unsigned long alocacoesAntigo = alocacoesAteAgora() - antes;
+    double tempoAntigo = segundosDesde(&inicio);
+
+    // 2. Motor: mesmas partidas, a sessão é só reiniciada
+    estado = 99u;
+    long passosMotor = 0, pistasMotor = 0;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    antes = alocacoesAteAgora();
+    for (int p = 0; p < partidas; p++) {
+        reiniciarSessaoExploracao(&sessao, &motor);
+        int atual = 0;
+        while (1) {
+            passosMotor++;
+            pistasMotor += entrarComodo(&motor, &sessao, atual);
+            int filhos[2] = { mapa.comodos[atual].esquerda, mapa.comodos[atual].direita };
+            if (filhos[0] < 0 && filhos[1] < 0) break;
+            int lado = (int)(proximoAleatorio(&estado) & 1);
+            atual = filhos[lado] >= 0 ? filhos[lado] : filhos[1 - lado];
+        }
+        pistasContraSuspeito(&motor, &sessao, "Elias");
+    }
+    unsigned long alocacoesMotor = alocacoesAteAgora() - antes;
+    double tempoMotor = segundosDesde(&inicio);
+
+    printf("Mansão com %d cômodos (%d pistas, %d suspeitos), %d partidas:\n",
+           mapa.quantidade, motor.totalPistas, motor.suspeitos, partidas);
+    printf("  BST + Hash: %ld passos, %ld pistas, %lu alocações, %.3f s\n",
+           passosAntigo, pistasAntigo, alocacoesAntigo, tempoAntigo);
+    printf("  Motor:      %ld passos, %ld pistas, %lu alocações, %.3f s\n",
+           passosMotor, pistasMotor, alocacoesMotor, tempoMotor);
+
+    int resultado = 0;
+    if (alocacoesMotor != 0 || passosMotor != passosAntigo || pistasMotor != pistasAntigo) {
+        printf("FALHA: o motor deveria repetir as partidas sem nenhuma alocação.\n");
+        resultado = 1;
+    } else {
+        printf("OK: exploração em regime sem nenhuma alocação.\n");
+    }
+
+    liberarSessaoExploracao(&sessao);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return resultado;
+}
+
+// -------------------------------------------------------------------
+// 13. RESUMO DE PISTAS POR SUBÁRVORE
+// -------------------------------------------------------------------
+
+// Cada cômodo guarda quantas pistas ainda não coletadas existem na sua
+// subárvore, no total e por suspeito. O resumo é montado uma vez, de baixo
+// para cima, e cada coleta (ou devolução) só ajusta o caminho até a
+// raiz, em O(profundidade). Uma dica custa O(suspeitos), qualquer que seja
+// o tamanho da mansão. É o estado da partida: mapa e motor só são lidos.
+struct ResumoSubarvores {
+    const MapaIndexado* mapa;
+    const MotorExploracao* motor;   // Índices de suspeitos
+    int suspeitos;
+    int* restantes;                 // restantes[id * suspeitos + s]
+    int* totalRestante;             // Por cômodo
+    unsigned char* coletada;        // Por cômodo: pista já coletada
+};
+
+// Uma única alocação (contagens e flags), com nenhuma pista coletada
+static void alocarResumo(ResumoSubarvores* resumo, const MapaIndexado* mapa, const MotorExploracao* motor) {
+    size_t n = (size_t)mapa->quantidade;
+    size_t s = (size_t)motor->suspeitos;
+    resumo->mapa = mapa;
+    resumo->motor = motor;
+    resumo->suspeitos = motor->suspeitos;
+    resumo->restantes = (int*)calloc(1, sizeof(int) * (n * s + n) + n + 1);
+    if (resumo->restantes == NULL) {
+        perror("Erro na alocação de memória para o resumo de pistas");
+        exit(EXIT_FAILURE);
+    }
+    resumo->totalRestante = resumo->restantes + n * s;
+    resumo->coletada = (unsigned char*)(resumo->totalRestante + n);
+}
+
+// Resumo de uma tabela gerada (seção 16): as contagens iniciais já vêm
+// prontas no cabeçalho e só são copiadas. O(n · suspeitos), sem cálculo.
+void prepararResumoDeTabela(ResumoSubarvores* resumo, const MapaIndexado* mapa, const MotorExploracao* motor,
+                            const int* restantes, const int* totalRestante) {
+    alocarResumo(resumo, mapa, motor);
+    size_t n = (size_t)mapa->quantidade;
+    memcpy(resumo->restantes, restantes, sizeof(int) * n * (size_t)motor->suspeitos);
+    memcpy(resumo->totalRestante, totalRestante, sizeof(int) * n);
+}
+
+// Monta o resumo com todas as pistas ainda por coletar. O(n · suspeitos).
+void prepararResumo(ResumoSubarvores* resumo, const MapaIndexado* mapa, const MotorExploracao* motor) {
+    alocarResumo(resumo, mapa, motor);
+    size_t s = (size_t)motor->suspeitos;
+    // Pré-ordem: os filhos têm ids maiores que o pai, então basta varrer de trás para frente
+    for (int id = mapa->quantidade - 1; id >= 0; id--) {
+        int* linha = resumo->restantes + (size_t)id * s;
+        if (motor->temPista[id]) {
+            linha[motor->suspeitoDe[id]]++;
+            resumo->totalRestante[id]++;
+        }
+        int filhos[2] = { mapa->comodos[id].esquerda, mapa->comodos[id].direita };
+        for (int f = 0; f < 2; f++) {
+            if (filhos[f] < 0) continue;
+            const int* filho = resumo->restantes + (size_t)filhos[f] * s;
+            for (size_t k = 0; k < s; k++) linha[k] += filho[k];
+            resumo->totalRestante[id] += resumo->totalRestante[filhos[f]];
+        }
+    }
+}
+
+void liberarResumo(ResumoSubarvores* resumo) {
+    free(resumo->restantes);
+    memset(resumo, 0, sizeof(*resumo));
+}
+
+// Marca a pista do cômodo 'comodo' (id) como coletada ou devolvida e propaga
+// a diferença até a raiz
+void marcarPistaColetada(ResumoSubarvores* resumo, int comodo, int coletada) {
+    coletada = coletada != 0;
+    if (!resumo->motor->temPista[comodo] || resumo->coletada[comodo] == coletada) return;
+    resumo->coletada[comodo] = (unsigned char)coletada;
+
+    int delta = coletada ? -1 : 1;
+    int suspeito = resumo->motor->suspeitoDe[comodo];
+    for (int id = comodo; id >= 0; id = resumo->mapa->pai[id]) {
+        resumo->restantes[(size_t)id * (size_t)resumo->suspeitos + (size_t)suspeito] += delta;
+        resumo->totalRestante[id] += delta;
+    }
+}
+
+int pistaColetada(const ResumoSubarvores* resumo, int comodo) {
+    return resumo->coletada[comodo];
+}
+
+// Pistas não coletadas na subárvore do cômodo: total e vetor por suspeito (O(1))
+const int* pistasRestantesAbaixo(const ResumoSubarvores* resumo, int comodo, int* total) {
+    if (total != NULL) *total = resumo->totalRestante[comodo];
+    return resumo->restantes + (size_t)comodo * (size_t)resumo->suspeitos;
+}
+
+// Dica para o jogador: o que ainda falta encontrar a partir daqui. O(suspeitos).
+void exibirDicaSubarvore(const ResumoSubarvores* resumo, int comodo) {
+    int total;
+    const int* porSuspeito = pistasRestantesAbaixo(resumo, comodo, &total);
+    if (total == 0) {
+        printf("🧭 Dica: não restam pistas a partir deste cômodo.\n");
+        return;
+    }
+    printf("🧭 Dica: ainda restam %d pista(s) a partir daqui:", total);
+    const char* separador = " ";
+    for (int s = 0; s < resumo->suspeitos; s++) {
+        if (porSuspeito[s] == 0) continue;
+        printf("%s%s %d", separador, resumo->motor->nomeSuspeito[s], porSuspeito[s]);
+        separador = ", ";
+    }
+    printf("\n");
+}
+
+// Confere o resumo contra a contagem direta na subárvore (intervalo da
+// pré-ordem) depois de coletas e devoluções aleatórias, e compara os tempos.
+int medirDicas(int quantidade, int operacoes) {
+    if (quantidade <= 0 || operacoes <= 0) {
+        printf("Uso: ./mestre --medir-dicas [cômodos [operações]]  (ambos > 0)\n");
+        return 1;
+    }
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = gerarMansao(quantidade, 4321u, &armazem);
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    MotorExploracao motor;
+    prepararMotor(&motor, &mapa, &armazem);
+    ResumoSubarvores resumo;
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    prepararResumo(&resumo, &mapa, &motor);
+    double tempoMontagem = segundosDesde(&inicio);
+
+    unsigned int estado = 17u;
+    int* contagem = (int*)calloc((size_t)(motor.suspeitos > 0 ? motor.suspeitos : 1), sizeof(int));
+    if (contagem == NULL) {
+        perror("Erro na alocação de memória");
+        exit(EXIT_FAILURE);
+    }
+    double tempoAtualizacao = 0, tempoDica = 0, tempoDireto = 0;
+    long long conferidas = 0, erradas = 0, soma = 0;
+    for (int i = 0; i < operacoes; i++) {
+        // 1. Coleta (ou devolve) uma pista qualquer
+        int alvo = (int)(proximoAleatorio(&estado) % (unsigned int)mapa.quantidade);
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        marcarPistaColetada(&resumo, alvo, !resumo.coletada[alvo]);
+        tempoAtualizacao += segundosDesde(&inicio);
+
+        // 2. Dica num cômodo raso (subárvores grandes são o caso caro)
+        int id = (int)(proximoAleatorio(&estado) % (unsigned int)(mapa.quantidade < 64 ? mapa.quantidade : 64));
+        int total;
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        const int* porSuspeito = pistasRestantesAbaixo(&resumo, id, &total);
+        for (int s = 0; s < motor.suspeitos; s++) soma += porSuspeito[s];
+        tempoDica += segundosDesde(&inicio);
+
+        // 3. Contagem direta, percorrendo a subárvore inteira
+        clock_gettime(CLOCK_MONOTONIC, &inicio);
+        memset(contagem, 0, sizeof(int) * (size_t)motor.suspeitos);
+        int direto = 0;
+        for (int c = id; c <= mapa.fimSubarvore[id]; c++) {
+            if (motor.temPista[c] && !resumo.coletada[c]) {
+                contagem[motor.suspeitoDe[c]]++;
+                direto++;
+            }
+        }
+        tempoDireto += segundosDesde(&inicio);
+
+        conferidas++;
+        if (direto != total || memcmp(contagem, porSuspeito, sizeof(int) * (size_t)motor.suspeitos) != 0) erradas++;
+    }
+
+    printf("Mansão com %d cômodos (%d pistas, %d suspeitos): resumo montado em %.3f s\n",
+           mapa.quantidade, motor.totalPistas, motor.suspeitos, tempoMontagem);
+    printf("%d operações: atualização média %.2f us | dica média %.3f us | contagem direta média %.2f us\n",
+           operacoes, tempoAtualizacao * 1e6 / operacoes, tempoDica * 1e6 / operacoes, tempoDireto * 1e6 / operacoes);
+    printf("Dicas conferidas: %lld | divergentes: %lld (soma de controle %lld)\n", conferidas, erradas, soma);
+
+    free(contagem);
+    liberarResumo(&resumo);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return erradas == 0 ? 0 : 1;
+}
+
+// -------------------------------------------------------------------
+// 14. MODO SERVIDOR (VÁRIOS JOGADORES, EPOLL)
+// -------------------------------------------------------------------
+
+// Um único processo atende muitas conexões sobre uma mansão compartilhada
+// (somente leitura). Protocolo de texto, um comando por linha:
+//   E / D         -> anda para a esquerda/direita
+//   R             -> volta ao Hall de Entrada (raiz)
+//   A <suspeito>  -> acusação com as pistas da sessão
+//   P             -> placar global de suspeitos
+//   Q             -> encerra a conexão
+// Ao conectar, a sessão já está no Hall de Entrada e recebe a linha OK dele
+// (com a pista do Hall, como no jogo interativo). Depois, cada comando gera
+// exatamente uma linha de resposta:
+//   OK <cômodo>[\tPISTA <suspeito>][\tFIM]  |  ERRO <motivo>
+//   VEREDITO <pistas> SUSTENTAVEL|INSUFICIENTE|SEM_BASE  |  PLACAR nome=n,...
+// Contrapressão: um comando só é executado se a maior resposta possível (a do
+// placar) couber na saída. Sem espaço, a sessão para de ler o socket até a
+// saída esvaziar, e o cliente que manda comandos em sequência apenas espera.
+#define TAM_ENTRADA_SESSAO 256
+#define TAM_SAIDA_SESSAO 2048
+#define RESPOSTA_MAXIMA (TAM_SAIDA_SESSAO / 2 + 16)
+#define EVENTOS_POR_ITERACAO 256
+
+// Estado de uma conexão: exploração (posição, pistas, contagens) e buffers
+typedef struct Sessao {
+    int ativa;
+    SessaoExploracao exploracao;
+    char entrada[TAM_ENTRADA_SESSAO];
+    size_t usadoEntrada;
+    char saida[TAM_SAIDA_SESSAO];
+    size_t usadoSaida;
+    int pendente;                  // Já está na lista de respostas a enviar
+    int pausada;                   // Saída cheia: comandos recebidos esperam
+    uint32_t eventos;              // Eventos registrados no epoll
+} Sessao;
+
+typedef struct Servidor {
+    int escuta;
+    int epoll;
+    MapaIndexado mapa;
+    MotorExploracao motor;
+    PlacarGlobal* placar;
+    Sessao** sessoes;              // Indexado pelo descritor
+    int capacidadeSessoes;
+    int* pendentes;                // Descritores com resposta acumulada nesta iteração
+    int quantidadePendentes;
+    long conexoes, comandos, escritas;
+} Servidor;
+
+static volatile sig_atomic_t servidorAtivo = 1;
+
+void pararServidor(int sinal) {
+    (void)sinal;
+    servidorAtivo = 0;
+}
+
+int tornarNaoBloqueante(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// Permite milhares de conexões: sobe o limite de descritores até o máximo permitido
+void ampliarLimiteDescritores(void) {
+    struct rlimit limite;
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+}
+
+// Endereço: só dígitos = porta TCP em 127.0.0.1; qualquer outra coisa = socket Unix
+int ehPortaTcp(const char* endereco) {
+    if (*endereco == '\0') return 0;
+    for (const char* p = endereco; *p != '\0'; p++) {
+        if (!isdigit((unsigned char)*p)) return 0;
+    }
+    return 1;
+}
+
+// Monta o sockaddr do endereço; retorna o tamanho e o domínio em '*dominio',
+// ou 0 se o endereço não couber (porta fora de 1..65535, caminho longo demais)
+socklen_t montarEndereco(const char* endereco, struct sockaddr_storage* destino, int* dominio) {
+    memset(destino, 0, sizeof(*destino));
+    if (ehPortaTcp(endereco)) {
+        long porta = strlen(endereco) <= 5 ? atol(endereco) : 0;
+        if (porta < 1 || porta > 65535) {
+            printf("Porta TCP inválida: %s\n", endereco);
+            return 0;
+        }
+        struct sockaddr_in* tcp = (struct sockaddr_in*)destino;
+        tcp->sin_family = AF_INET;
+        tcp->sin_port = htons((uint16_t)porta);
+        tcp->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        *dominio = AF_INET;
+        return sizeof(*tcp);
+    }
+    struct sockaddr_un* local = (struct sockaddr_un*)destino;
+    if (endereco[0] == '\0' || strlen(endereco) >= sizeof(local->sun_path)) {
+        printf("Caminho de socket inválido (vazio ou com mais de %zu bytes): %s\n",
+               sizeof(local->sun_path) - 1, endereco);
+        return 0;
+    }
+    local->sun_family = AF_UNIX;
+    memcpy(local->sun_path, endereco, strlen(endereco) + 1);
+    *dominio = AF_UNIX;
+    return sizeof(*local);
+}
+
+// Remove um socket Unix deixado por uma execução anterior. Só apaga se o
+// caminho for mesmo um socket; retorna -1 se existir outra coisa ali.
+int removerSocketAntigo(const char* caminho) {
+    struct stat info;
+    if (lstat(caminho, &info) != 0) return 0;
+    if (!S_ISSOCK(info.st_mode)) {
+        printf("'%s' já existe e não é um socket; escolha outro caminho.\n", caminho);
+        return -1;
+    }
+    return unlink(caminho);
+}
+
+// Acrescenta uma linha à saída da sessão; ela é enviada no fim da iteração
+void responder(Servidor* servidor, int fd, const char* formato, ...) {
+    Sessao* sessao = servidor->sessoes[fd];
+    size_t livre = TAM_SAIDA_SESSAO - sessao->usadoSaida;
+    va_list argumentos;
+    va_start(argumentos, formato);
+    int escritos = vsnprintf(sessao->saida + sessao->usadoSaida, livre, formato, argumentos);
+    va_end(argumentos);
+    // Não acontece com a contrapressão de executarLinhas; se acontecer, é erro
+    if (escritos < 0 || (size_t)escritos >= livre) {
+        sessao->ativa = 0;
+        return;
+    }
+    sessao->usadoSaida += (size_t)escritos;
+    if (!sessao->pendente) {
+        sessao->pendente = 1;
+        servidor->pendentes[servidor->quantidadePendentes++] = fd;
+    }
+}
+
+// Leva a sessão ao cômodo 'id', coleta a pista (uma vez por sessão) e responde OK
+void entrarNoComodo(Servidor* servidor, int fd, int id) {
+    Sessao* sessao = servidor->sessoes[fd];
+    const MapaIndexado* mapa = &servidor->mapa;
+    const ComodoIndexado* comodo = &mapa->comodos[id];
+    int novaPista = entrarComodo(&servidor->motor, &sessao->exploracao, id);
+    if (novaPista) incrementarPlacar(servidor->placar, comodo->suspeito_associado, 1);
+    int folha = comodo->esquerda < 0 && comodo->direita < 0;
+    responder(servidor, fd, "OK %s%s%s%s\n", comodo->nome,
+              novaPista ? "\tPISTA " : "", novaPista ? comodo->suspeito_associado : "",
+              folha ? "\tFIM" : "");
+}
+
+// Executa um comando da sessão
+void processarComando(Servidor* servidor, int fd, char* linha) {
+    Sessao* sessao = servidor->sessoes[fd];
+    const MapaIndexado* mapa = &servidor->mapa;
+    servidor->comandos++;
+
+    char comando = (char)toupper((unsigned char)linha[0]);
+    if (comando == 'E' || comando == 'D' || comando == 'R') {
+        int atual = sessao->exploracao.atual;
+        int proximo = comando == 'R' ? 0 : comando == 'E' ? mapa->comodos[atual].esquerda : mapa->comodos[atual].direita;
+        if (proximo < 0) {
+            responder(servidor, fd, "ERRO caminho inexistente\n");
+            return;
+        }
+        entrarNoComodo(servidor, fd, proximo);
+    } else if (comando == 'A') {
+        const char* acusado = linha + 1;
+        while (*acusado == ' ') acusado++;
+        int pistas = pistasContraSuspeito(&servidor->motor, &sessao->exploracao, acusado);
+        responder(servidor, fd, "VEREDITO %d %s\n", pistas, NOMES_VEREDITO[classificarVeredito(pistas)]);
+    } else if (comando == 'P') {
+        char placar[RESPOSTA_MAXIMA - 16];
+        size_t usado = 0;
+        placar[0] = '\0';
+        for (int i = 0; i < CAPACIDADE_PLACAR; i++) {
+            const char* nome = atomic_load_explicit(&servidor->placar->entradas[i].suspeito, memory_order_acquire);
+            if (nome == NULL) continue;
+            int n = snprintf(placar + usado, sizeof(placar) - usado, "%s%s=%ld", usado > 0 ? "," : "",
+                             nome, lerPlacar(servidor->placar, nome));
+            if (n < 0 || (size_t)n >= sizeof(placar) - usado) break;
+            usado += (size_t)n;
+        }
+        responder(servidor, fd, "PLACAR %s\n", placar);
+    } else if (comando == 'Q') {
+        sessao->ativa = 0;
+    } else {
+        responder(servidor, fd, "ERRO comando desconhecido\n");
+    }
+}
+
+void encerrarSessao(Servidor* servidor, int fd) {
+    Sessao* sessao = servidor->sessoes[fd];
+    if (sessao == NULL) return;
+    epoll_ctl(servidor->epoll, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    liberarSessaoExploracao(&sessao->exploracao);
+    free(sessao);
+    servidor->sessoes[fd] = NULL;
+}
+
+void aceitarConexoes(Servidor* servidor) {
+    while (1) {
+        int fd = accept(servidor->escuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) perror("accept");
+            return;
+        }
+        tornarNaoBloqueante(fd);
+        int sim = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim)); // Ignorado em socket Unix
+
+        if (fd >= servidor->capacidadeSessoes) {
+            int nova = servidor->capacidadeSessoes;
+            while (nova <= fd) nova *= 2;
+            Sessao** sessoes = (Sessao**)realloc(servidor->sessoes, sizeof(Sessao*) * (size_t)nova);
+            int* pendentes = (int*)realloc(servidor->pendentes, sizeof(int) * (size_t)nova);
+            if (sessoes == NULL || pendentes == NULL) {
+                perror("Erro na alocação de memória para as sessões");
+                exit(EXIT_FAILURE);
+            }
+            for (int i = servidor->capacidadeSessoes; i < nova; i++) sessoes[i] = NULL;
+            servidor->sessoes = sessoes;
+            servidor->pendentes = pendentes;
+            servidor->capacidadeSessoes = nova;
+        }
+
+        Sessao* sessao = (Sessao*)calloc(1, sizeof(Sessao));
+        if (sessao == NULL) {
+            close(fd);
+            continue;
+        }
+        sessao->ativa = 1;
+        sessao->eventos = EPOLLIN;
+        criarSessaoExploracao(&sessao->exploracao, &servidor->motor);
+        servidor->sessoes[fd] = sessao;
+
+        struct epoll_event evento = { .events = EPOLLIN, .data.fd = fd };
+        if (epoll_ctl(servidor->epoll, EPOLL_CTL_ADD, fd, &evento) < 0) {
+            encerrarSessao(servidor, fd);
+            continue;
+        }
+        servidor->conexoes++;
+        entrarNoComodo(servidor, fd, 0); // A partida começa no Hall, como no jogo interativo
+    }
+}
+
+static inline int saidaTemEspaco(const Sessao* sessao) {
+    return TAM_SAIDA_SESSAO - sessao->usadoSaida >= RESPOSTA_MAXIMA;
+}
+
+// Executa as linhas completas já recebidas enquanto houver espaço para as
+// respostas; sem espaço, a sessão fica pausada com o resto guardado
+void executarLinhas(Servidor* servidor, int fd) {
+    Sessao* sessao = servidor->sessoes[fd];
+    char* inicio = sessao->entrada;
+    char* fim = sessao->entrada + sessao->usadoEntrada;
+    char* quebra;
+    sessao->pausada = 0;
+    while (sessao->ativa && (quebra = memchr(inicio, '\n', (size_t)(fim - inicio))) != NULL) {
+        if (!saidaTemEspaco(sessao)) {
+            sessao->pausada = 1;
+            break;
+        }
+        *quebra = '\0';
+        if (quebra > inicio && quebra[-1] == '\r') quebra[-1] = '\0';
+        if (*inicio != '\0') processarComando(servidor, fd, inicio);
+        inicio = quebra + 1;
+    }
+    sessao->usadoEntrada = (size_t)(fim - inicio);
+    memmove(sessao->entrada, inicio, sessao->usadoEntrada);
+}
+
+// Executa o que já estava guardado e lê o que estiver disponível, até o socket
+// esvaziar ou a sessão pausar por falta de espaço na saída
+void lerSessao(Servidor* servidor, int fd) {
+    Sessao* sessao = servidor->sessoes[fd];
+    executarLinhas(servidor, fd);
+    while (sessao->ativa && !sessao->pausada) {
+        // Linha maior que o buffer: cliente inválido
+        if (sessao->usadoEntrada == TAM_ENTRADA_SESSAO - 1) {
+            sessao->ativa = 0;
+            break;
+        }
+        ssize_t lidos = read(fd, sessao->entrada + sessao->usadoEntrada, TAM_ENTRADA_SESSAO - 1 - sessao->usadoEntrada);
+        if (lidos == 0) {
+            sessao->ativa = 0;
+            break;
+        }
+        if (lidos < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) sessao->ativa = 0;
+            break;
+        }
+        sessao->usadoEntrada += (size_t)lidos;
+        executarLinhas(servidor, fd);
+    }
+}
+
+// Envia a saída acumulada da sessão. EPOLLOUT fica ligado enquanto sobrar
+// saída (socket cheio) e EPOLLIN desligado enquanto a sessão estiver pausada
+void escreverSessao(Servidor* servidor, int fd) {
+    Sessao* sessao = servidor->sessoes[fd];
+    size_t enviado = 0;
+    while (enviado < sessao->usadoSaida) {
+        ssize_t n = write(fd, sessao->saida + enviado, sessao->usadoSaida - enviado);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) sessao->ativa = 0;
+            break;
+        }
+        enviado += (size_t)n;
+    }
+    servidor->escritas++;
+    sessao->usadoSaida -= enviado;
+    memmove(sessao->saida, sessao->saida + enviado, sessao->usadoSaida);
+
+    uint32_t eventos = (sessao->pausada ? 0 : EPOLLIN) | (sessao->usadoSaida > 0 ? EPOLLOUT : 0);
+    if (eventos != sessao->eventos && sessao->ativa) {
+        struct epoll_event evento = { .events = eventos, .data.fd = fd };
+        epoll_ctl(servidor->epoll, EPOLL_CTL_MOD, fd, &evento);
+        sessao->eventos = eventos;
+    }
+}
+
+int abrirEscuta(const char* endereco) {
+    struct sockaddr_storage destino;
+    int dominio;
+    socklen_t tamanho = montarEndereco(endereco, &destino, &dominio);
+    if (tamanho == 0) return -1;
+    if (dominio == AF_UNIX && removerSocketAntigo(endereco) != 0) return -1;
+
+    int fd = socket(dominio, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("socket");
+        return -1;
+    }
+    int sim = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &sim, sizeof(sim));
+    if (bind(fd, (struct sockaddr*)&destino, tamanho) < 0 || listen(fd, SOMAXCONN) < 0 || tornarNaoBloqueante(fd) < 0) {
+        perror("Erro ao abrir o socket do servidor");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Atende jogadores até receber SIGINT/SIGTERM. Com 'comodos' > 0, usa uma
+// mansão gerada desse tamanho; senão, a mansão de demonstração.
+int executarServidor(const char* endereco, int comodos) {
+    ampliarLimiteDescritores();
+    signal(SIGPIPE, SIG_IGN);
+    struct sigaction parada;
+    memset(&parada, 0, sizeof(parada));
+    parada.sa_handler = pararServidor;
+    sigaction(SIGINT, &parada, NULL);
+    sigaction(SIGTERM, &parada, NULL);
+
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = comodos > 0 ? gerarMansao(comodos, 777u, &armazem) : montarMapa(&armazem);
+    PlacarGlobal placar;
+    inicializarPlacar(&placar);
+
+    Servidor servidor;
+    memset(&servidor, 0, sizeof(servidor));
+    indexarMapa(&servidor.mapa, mansao);
+    prepararMotor(&servidor.motor, &servidor.mapa, &armazem);
+    servidor.placar = &placar;
+    servidor.capacidadeSessoes = 1024;
+    servidor.sessoes = (Sessao**)calloc((size_t)servidor.capacidadeSessoes, sizeof(Sessao*));
+    servidor.pendentes = (int*)malloc(sizeof(int) * (size_t)servidor.capacidadeSessoes);
+    if (servidor.sessoes == NULL || servidor.pendentes == NULL) {
+        perror("Erro na alocação de memória para as sessões");
+        exit(EXIT_FAILURE);
+    }
+    servidor.escuta = abrirEscuta(endereco);
+    servidor.epoll = servidor.escuta >= 0 ? epoll_create1(0) : -1;
+    if (servidor.escuta < 0 || servidor.epoll < 0) {
+        if (servidor.escuta >= 0) {
+            perror("epoll_create1");
+            close(servidor.escuta);
+            removerSocketAntigo(endereco);
+        }
+        free(servidor.sessoes);
+        free(servidor.pendentes);
+        liberarMotor(&servidor.motor);
+        liberarMapaIndexado(&servidor.mapa);
+        liberarMapa(mansao);
+        liberarPlacar(&placar);
+        liberarArmazem(&armazem);
+        return 1;
+    }
+    struct epoll_event evento = { .events = EPOLLIN, .data.fd = servidor.escuta };
+    epoll_ctl(servidor.epoll, EPOLL_CTL_ADD, servidor.escuta, &evento);
+
+    printf("Servidor ouvindo em %s (%d cômodos). Ctrl+C encerra.\n", endereco, servidor.mapa.quantidade);
+    fflush(stdout);
+
+    struct epoll_event eventos[EVENTOS_POR_ITERACAO];
+    while (servidorAtivo) {
+        int prontos = epoll_wait(servidor.epoll, eventos, EVENTOS_POR_ITERACAO, 500);
+        if (prontos < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        // 1. Lê e executa os comandos de todas as conexões prontas
+        for (int i = 0; i < prontos; i++) {
+            int fd = eventos[i].data.fd;
+            if (fd == servidor.escuta) {
+                aceitarConexoes(&servidor);
+                continue;
+            }
+            Sessao* sessao = servidor.sessoes[fd];
+            if (sessao == NULL) continue;
+            if (eventos[i].events & (EPOLLERR | EPOLLHUP)) sessao->ativa = 0;
+            if (eventos[i].events & EPOLLIN) lerSessao(&servidor, fd);
+            if ((eventos[i].events & EPOLLOUT) && !sessao->pendente) {
+                sessao->pendente = 1;
+                servidor.pendentes[servidor.quantidadePendentes++] = fd;
+            }
+            if (!sessao->ativa && !sessao->pendente) encerrarSessao(&servidor, fd);
+        }
+
+        // 2. Uma escrita por conexão com todas as respostas da iteração
+        for (int i = 0; i < servidor.quantidadePendentes; i++) {
+            int fd = servidor.pendentes[i];
+            Sessao* sessao = servidor.sessoes[fd];
+            escreverSessao(&servidor, fd); // Mesmo encerrando, entrega as últimas respostas (ex.: antes do Q)
+            // Sessão pausada cuja saída esvaziou: retoma os comandos guardados
+            // (continua marcada como pendente, então não volta para a lista)
+            while (sessao->ativa && sessao->pausada && saidaTemEspaco(sessao)) {
+                lerSessao(&servidor, fd);
+                escreverSessao(&servidor, fd);
+            }
+            sessao->pendente = 0;
+            if (!sessao->ativa) encerrarSessao(&servidor, fd);
+        }
+        servidor.quantidadePendentes = 0;
+    }
+
+    printf("\nServidor encerrado: %ld conexões, %ld comandos, %ld escritas.\n",
+           servidor.conexoes, servidor.comandos, servidor.escritas);
+    printf("Placar global:\n");
+    exibirPlacar(&placar);
+
+    for (int fd = 0; fd < servidor.capacidadeSessoes; fd++) {
+        if (servidor.sessoes[fd] != NULL) encerrarSessao(&servidor, fd);
+    }
+    close(servidor.epoll);
+    close(servidor.escuta);
+    if (!ehPortaTcp(endereco)) removerSocketAntigo(endereco);
+    free(servidor.sessoes);
+    free(servidor.pendentes);
+    liberarMotor(&servidor.motor);
+    liberarMapaIndexado(&servidor.mapa);
+    liberarMapa(mansao);
+    liberarPlacar(&placar);
+    liberarArmazem(&armazem);
+    return 0;
+}
+
+// -------------------------------------------------------------------
+// Gerador de carga: N conexões simultâneas, cada uma com um comando em voo
+// -------------------------------------------------------------------
+
+typedef struct ConexaoCarga {
+    int fd;
+    int restantes;              // Movimentos que ainda faltam
+    char proximo;               // Próximo comando a enviar
+    struct timespec envio;
+    char resposta[256];
+    size_t usado;
+    int aguardandoHall;         // A primeira linha (o Hall) ainda não chegou
+} ConexaoCarga;
+
+int compararLatencias(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+int conectarServidor(const char* endereco) {
+    struct sockaddr_storage destino;
+    int dominio;
+    socklen_t tamanho = montarEndereco(endereco, &destino, &dominio);
+    if (tamanho == 0) return -1;
+    int fd = socket(dominio, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    // Conexão bloqueante: com a fila de escuta cheia, espera em vez de falhar
+    if (connect(fd, (struct sockaddr*)&destino, tamanho) < 0) {
+        close(fd);
+        return -1;
+    }
+    int sim = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim));
+    tornarNaoBloqueante(fd);
+    return fd;
+}
+
+int enviarComando(ConexaoCarga* conexao) {
+    char linha[4] = { conexao->proximo, '\n', '\0' };
+    clock_gettime(CLOCK_MONOTONIC, &conexao->envio);
+    return write(conexao->fd, linha, 2) == 2 ? 0 : -1;
+}
+
+// Mede a latência de cada movimento com 'quantidade' conexões simultâneas
+int rodadaDeCarga(const char* endereco, int quantidade, int movimentos, unsigned int* estado) {
+    ConexaoCarga* conexoes = (ConexaoCarga*)calloc((size_t)quantidade, sizeof(ConexaoCarga));
+    double* latencias = (double*)malloc(sizeof(double) * (size_t)quantidade * (size_t)movimentos);
+    int epoll = epoll_create1(0);
+    if (conexoes == NULL || latencias == NULL || epoll < 0) {
+        perror("Erro ao preparar a carga");
+        exit(EXIT_FAILURE);
+    }
+
+    int abertas = 0;
+    for (int i = 0; i < quantidade; i++) {
+        conexoes[i].fd = conectarServidor(endereco);
+        if (conexoes[i].fd < 0) {
+            printf("Falha ao conectar a conexão %d: %s\n", i, strerror(errno));
+            break;
+        }
+        struct epoll_event evento = { .events = EPOLLIN, .data.u32 = (uint32_t)i };
+        epoll_ctl(epoll, EPOLL_CTL_ADD, conexoes[i].fd, &evento);
+        conexoes[i].restantes = movimentos;
+        conexoes[i].aguardandoHall = 1;
+        abertas++;
+    }
+
+    // Cada conexão manda o primeiro movimento assim que recebe a linha do Hall
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int ativas = abertas;
+
+    size_t medidas = 0;
+    int erros = 0;
+    struct epoll_event eventos[EVENTOS_POR_ITERACAO];
+    while (ativas > 0) {
+        int prontos = epoll_wait(epoll, eventos, EVENTOS_POR_ITERACAO, 5000);
+        if (prontos <= 0) {
+            if (prontos < 0 && errno == EINTR) continue;
+            printf("Tempo esgotado esperando respostas (%d conexões ativas)\n", ativas);
+            erros++;
+            break;
+        }
+        for (int e = 0; e < prontos; e++) {
+            ConexaoCarga* conexao = &conexoes[eventos[e].data.u32];
+            ssize_t lidos = read(conexao->fd, conexao->resposta + conexao->usado,
+                                 sizeof(conexao->resposta) - 1 - conexao->usado);
+            if (lidos <= 0) {
+                if (lidos < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+                conexao->restantes = 0;
+                ativas--;
+                erros++;
+                continue;
+            }
+            conexao->usado += (size_t)lidos;
+            conexao->resposta[conexao->usado] = '\0';
+            char* quebra = strchr(conexao->resposta, '\n');
+            if (quebra == NULL) continue;
+
+            // Uma resposta completa: mede e envia o próximo movimento
+            int fim = strstr(conexao->resposta, "\tFIM") != NULL || strncmp(conexao->resposta, "ERRO", 4) == 0;
+            conexao->usado = 0;
+            if (conexao->aguardandoHall) {
+                conexao->aguardandoHall = 0;
+            } else {
+                latencias[medidas++] = segundosDesde(&conexao->envio);
+                if (--conexao->restantes == 0) {
+                    ativas--;
+                    continue;
+                }
+            }
+            conexao->proximo = fim ? 'R' : (proximoAleatorio(estado) & 1) ? 'E' : 'D';
+            if (enviarComando(conexao) != 0) {
+                conexao->restantes = 0;
+                ativas--;
+                erros++;
+            }
+        }
+    }
+    double duracao = segundosDesde(&inicio);
+
+    qsort(latencias, medidas, sizeof(double), compararLatencias);
+    if (medidas > 0) {
+        printf("%10d | %10zu | %9.1f | %9.1f | %9.1f | %12.0f\n", abertas, medidas,
+               latencias[medidas / 2] * 1e6, latencias[(size_t)((double)medidas * 0.99)] * 1e6,
+               latencias[medidas - 1] * 1e6, (double)medidas / duracao);
+    }
+
+    for (int i = 0; i < abertas; i++) close(conexoes[i].fd);
+    close(epoll);
+    free(conexoes);
+    free(latencias);
+    return erros == 0 && abertas == quantidade ? 0 : 1;
+}
+
+// Roda rodadas de carga com número crescente de conexões (lista separada por vírgulas)
+int executarCarga(const char* endereco, const char* listaConexoes, int movimentos) {
+    ampliarLimiteDescritores();
+    signal(SIGPIPE, SIG_IGN);
+    unsigned int estado = 4242u;
+    int resultado = 0;
+
+    printf("%10s | %10s | %9s | %9s | %9s | %12s\n", "conexões", "movimentos", "p50 (us)", "p99 (us)", "máx (us)", "movimentos/s");
+    char lista[256];
+    strncpy(lista, listaConexoes, sizeof(lista) - 1);
+    lista[sizeof(lista) - 1] = '\0';
+    for (char* item = strtok(lista, ","); item != NULL; item = strtok(NULL, ",")) {
+        int quantidade = atoi(item);
+        if (quantidade <= 0) continue;
+        resultado |= rodadaDeCarga(endereco, quantidade, movimentos, &estado);
+    }
+    return resultado;
+}
+
+// -------------------------------------------------------------------
+// Conferência: o servidor e o jogo interativo dão o mesmo veredito
+// -------------------------------------------------------------------
+
+// Lê uma linha do socket (bloqueante, com o tempo limite do socket)
+int lerLinhaConferencia(int fd, char* linha, size_t capacidade) {
+    size_t usado = 0;
+    while (usado + 1 < capacidade) {
+        char c;
+        if (read(fd, &c, 1) != 1) return -1;
+        if (c == '\n') break;
+        linha[usado++] = c;
+    }
+    linha[usado] = '\0';
+    return 0;
+}
+
+// Veredito cujo nome no protocolo é 'nome' (-1 se nenhum)
+int vereditoPorNome(const char* nome) {
+    for (int v = VEREDITO_SEM_BASE; v <= VEREDITO_SUSTENTAVEL; v++) {
+        if (strcmp(nome, NOMES_VEREDITO[v]) == 0) return v;
+    }
+    return -1;
+}
+
+// Joga 'movimentos' e acusa 'suspeito' numa conexão nova com o servidor.
+// Retorna 0 e preenche '*pistas' e '*veredito' em caso de sucesso.
+int jogarNoServidor(const char* endereco, const char* movimentos, const char* suspeito, int* pistas,
+                    Veredito* veredito) {
+    int fd = -1;
+    for (int tentativa = 0; tentativa < 100 && fd < 0; tentativa++) {
+        fd = conectarServidor(endereco);
+        if (fd < 0) usleep(20000); // O servidor ainda está subindo
+    }
+    if (fd < 0) return -1;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    struct timeval limite = { .tv_sec = 2, .tv_usec = 0 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &limite, sizeof(limite));
+
+    char linha[TAM_SAIDA_SESSAO];
+    int erro = lerLinhaConferencia(fd, linha, sizeof(linha)) != 0 || strncmp(linha, "OK ", 3) != 0;
+    for (const char* m = movimentos; *m != '\0' && !erro; m++) {
+        char comando[3] = { *m, '\n', '\0' };
+        erro = write(fd, comando, 2) != 2 || lerLinhaConferencia(fd, linha, sizeof(linha)) != 0 ||
+               strncmp(linha, "OK ", 3) != 0;
+    }
+    if (!erro) {
+        dprintf(fd, "A %s\nQ\n", suspeito);
+        char nome[32];
+        erro = lerLinhaConferencia(fd, linha, sizeof(linha)) != 0 || sscanf(linha, "VEREDITO %d %31s", pistas, nome) != 2;
+        int lido = erro ? -1 : vereditoPorNome(nome);
+        if (lido < 0) erro = 1;
+        else *veredito = (Veredito)lido;
+    }
+    close(fd);
+    return erro ? -1 : 0;
+}
+
+// Joga a mesma partida no modo interativo (este programa, sem argumentos). O
+// veredito é reconhecido pelo título que avaliarAcusacao imprime (TITULOS_VEREDITO).
+int jogarInterativo(const char* movimentos, int terminaEmFolha, const char* suspeito, int* pistas,
+                    Veredito* veredito) {
+    int entrada[2], saida[2];
+    if (pipe(entrada) != 0 || pipe(saida) != 0) return -1;
+    pid_t filho = fork();
+    if (filho < 0) return -1;
+    if (filho == 0) {
+        dup2(entrada[0], STDIN_FILENO);
+        dup2(saida[1], STDOUT_FILENO);
+        close(entrada[0]);
+        close(entrada[1]);
+        close(saida[0]);
+        close(saida[1]);
+        execl("/proc/self/exe", "mestre", (char*)NULL);
+        _exit(127);
+    }
+    close(entrada[0]);
+    close(saida[1]);
+
+    // Movimentos, 'F' se a partida para antes de uma folha, e o acusado
+    FILE* escrita = fdopen(entrada[1], "w");
+    for (const char* m = movimentos; *m != '\0'; m++) fprintf(escrita, "%c\n", *m);
+    if (!terminaEmFolha) fprintf(escrita, "F\n");
+    fprintf(escrita, "%s\n", suspeito);
+    fclose(escrita);
+
+    size_t capacidadeTexto = 1 << 16, usado = 0;
+    char* texto = (char*)malloc(capacidadeTexto);
+    if (texto == NULL) {
+        perror("Erro na alocação de memória para a conferência");
+        exit(EXIT_FAILURE);
+    }
+    ssize_t n;
+    while (usado + 1 < capacidadeTexto && (n = read(saida[0], texto + usado, capacidadeTexto - 1 - usado)) > 0) {
+        usado += (size_t)n;
+    }
+    texto[usado] = '\0';
+    close(saida[0]);
+    int estado = 0;
+    waitpid(filho, &estado, 0);
+
+    const char* contagem = strstr(texto, "Pistas Coletadas que o incriminam: **");
+    int erro = contagem == NULL || sscanf(contagem, "Pistas Coletadas que o incriminam: **%d", pistas) != 1;
+    int lido = -1;
+    for (int v = VEREDITO_SEM_BASE; v <= VEREDITO_SUSTENTAVEL; v++) {
+        if (strstr(texto, TITULOS_VEREDITO[v]) != NULL) lido = v;
+    }
+    if (lido < 0) erro = 1;
+    else *veredito = (Veredito)lido;
+    free(texto);
+    return erro || !WIFEXITED(estado) || WEXITSTATUS(estado) != 0 ? -1 : 0;
+}
+
+int conferirMansaoEstatica(void);
+
+// Sobe o servidor num socket temporário e, para cada cômodo da mansão de
+// demonstração como ponto de parada e cada suspeito, compara o veredito da
+// sessão no servidor com o do jogo interativo. Retorna 0 se todos coincidirem.
+int conferirServidor(void) {
+    // O jogo interativo usa a tabela compilada: se ela estiver defasada, as
+    // divergências abaixo viriam dela, e não do servidor
+    if (conferirMansaoEstatica() != 0) return 1;
+
+    char endereco[64];
+    snprintf(endereco, sizeof(endereco), "/tmp/mestre-conferencia-%d.sock", (int)getpid());
+    fflush(stdout);
+    pid_t servidor = fork();
+    if (servidor < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (servidor == 0) {
+        if (freopen("/dev/null", "w", stdout) == NULL) _exit(1);
+        _exit(executarServidor(endereco, 0));
+    }
+
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = montarMapa(&armazem);
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    const char* suspeitos[] = { "Elias", "Diana", "Bruno", "Ninguém" };
+    const int totalSuspeitos = (int)(sizeof(suspeitos) / sizeof(suspeitos[0]));
+
+    int partidas = 0, divergencias = 0, servidorFalhou = 0;
+    char movimentos[64];
+    for (int id = 0; id < mapa.quantidade && !servidorFalhou; id++) {
+        // Caminho do Hall até 'id', subindo pelos pais
+        int passos = mapa.profundidade[id];
+        if (passos >= (int)sizeof(movimentos)) continue;
+        movimentos[passos] = '\0';
+        for (int c = id; mapa.pai[c] >= 0; c = mapa.pai[c]) {
+            movimentos[--passos] = mapa.comodos[mapa.pai[c]].esquerda == c ? 'E' : 'D';
+        }
+        int folha = mapa.comodos[id].esquerda < 0 && mapa.comodos[id].direita < 0;
+
+        for (int s = 0; s < totalSuspeitos && !servidorFalhou; s++) {
+            int pistasServidor = -1, pistasJogo = -1;
+            Veredito vereditoServidor = VEREDITO_SEM_BASE, vereditoJogo = VEREDITO_SEM_BASE;
+            int falhaServidor = jogarNoServidor(endereco, movimentos, suspeitos[s], &pistasServidor, &vereditoServidor);
+            int falhaJogo = jogarInterativo(movimentos, folha, suspeitos[s], &pistasJogo, &vereditoJogo);
+            partidas++;
+            servidorFalhou = falhaServidor; // Sem resposta do servidor, as demais partidas também falhariam
+            if (falhaServidor || falhaJogo || pistasServidor != pistasJogo || vereditoServidor != vereditoJogo) {
+                printf("DIVERGÊNCIA em '%s' até %s, acusando %s: servidor %d %s | jogo %d %s\n",
+                       movimentos[0] != '\0' ? movimentos : "-", mapa.comodos[id].nome, suspeitos[s],
+                       pistasServidor, falhaServidor ? "(falhou)" : NOMES_VEREDITO[vereditoServidor],
+                       pistasJogo, falhaJogo ? "(falhou)" : NOMES_VEREDITO[vereditoJogo]);
+                divergencias++;
+            }
+        }
+    }
+
+    kill(servidor, SIGTERM);
+    waitpid(servidor, NULL, 0);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+
+    if (divergencias == 0) printf("OK: %d partidas com o mesmo veredito no servidor e no jogo interativo.\n", partidas);
+    else printf("FALHA: %d de %d partidas divergiram.\n", divergencias, partidas);
+    return divergencias == 0 ? 0 : 1;
+}
+
+// -------------------------------------------------------------------
+// 15. EXPORTAÇÃO COLUNAR DE SESSÕES
+// -------------------------------------------------------------------
+
+// Arquivo colunar simples (inteiros little-endian), no espírito do Arrow IPC:
+//   Cabeçalho: "DMCOLUN1", u32 versão,
+//              u32 suspeitos { u16 tamanho, nome },
+//              u32 cômodos { u16 tamanho, nome, i32 suspeito (-1), u32 tamanho, pista }
+//   Lotes:     "LOTE", u64 bytes do restante do lote, u32 linhas, u32 colunas,
+//              por coluna { u8 tipo, u16 tamanho, nome, u64 bytes, dados }
+//   Rodapé:    u64 deslocamento de cada lote, u32 lotes, u64 linhas, "FIMCOLUN"
+// Caminho e pistas são listas de ids de cômodo (offsets i32[linhas+1] seguidos
+// dos valores), e os textos ficam só no dicionário do cabeçalho. O gerador de
+// sessões escreve um lote por vez: a memória não depende do total exportado.
+#define LINHAS_POR_LOTE 65536
+#define VERSAO_COLUNAR 1
+#define COLUNA_INT64 1
+#define COLUNA_INT32 2
+#define COLUNA_UINT8 3
+#define COLUNA_LISTA_INT32 4
+
+typedef struct BufferBytes {
+    unsigned char* dados;
+    size_t usado, capacidade;
+} BufferBytes;
+
+static unsigned char* reservarBytes(BufferBytes* buffer, size_t extra) {
+    if (buffer->usado + extra > buffer->capacidade) {
+        size_t nova = buffer->capacidade ? buffer->capacidade : 4096;
+        while (nova < buffer->usado + extra) nova *= 2;
+        unsigned char* dados = (unsigned char*)realloc(buffer->dados, nova);
+        if (dados == NULL) {
+            perror("Erro na alocação de memória para a exportação");
+            exit(EXIT_FAILURE);
+        }
+        buffer->dados = dados;
+        buffer->capacidade = nova;
+    }
+    return buffer->dados + buffer->usado;
+}
+
+static void anexarInteiro(BufferBytes* buffer, uint64_t valor, int bytes) {
+    unsigned char* destino = reservarBytes(buffer, (size_t)bytes);
+    for (int i = 0; i < bytes; i++) destino[i] = (unsigned char)(valor >> (8 * i));
+    buffer->usado += (size_t)bytes;
+}
+
+static void anexarBytes(BufferBytes* buffer, const void* dados, size_t tamanho) {
+    memcpy(reservarBytes(buffer, tamanho), dados, tamanho);
+    buffer->usado += tamanho;
+}
+
+static uint64_t lerInteiro(const unsigned char* origem, int bytes) {
+    uint64_t valor = 0;
+    for (int i = 0; i < bytes; i++) valor |= (uint64_t)origem[i] << (8 * i);
+    return valor;
+}
+
+// Colunas de um lote em construção, reaproveitadas de um lote para o outro
+typedef struct LoteSessoes {
+    int linhas;
+    int suspeitos;
+    BufferBytes sessao;                     // i64
+    BufferBytes caminhoOffsets, caminho;    // lista<i32>
+    BufferBytes pistasOffsets, pistas;      // lista<i32>
+    BufferBytes* contagens;                 // i32, uma coluna por suspeito
+    BufferBytes acusado, pistasAcusado;     // i32
+    BufferBytes veredito;                   // u8
+} LoteSessoes;
+
+void reiniciarLote(LoteSessoes* lote) {
+    lote->linhas = 0;
+    BufferBytes* colunas[] = { &lote->sessao, &lote->caminhoOffsets, &lote->caminho, &lote->pistasOffsets,
+                               &lote->pistas, &lote->acusado, &lote->pistasAcusado, &lote->veredito };
+    for (size_t i = 0; i < sizeof(colunas) / sizeof(colunas[0]); i++) colunas[i]->usado = 0;
+    for (int s = 0; s < lote->suspeitos; s++) lote->contagens[s].usado = 0;
+    anexarInteiro(&lote->caminhoOffsets, 0, 4);
+    anexarInteiro(&lote->pistasOffsets, 0, 4);
+}
+
+void inicializarLote(LoteSessoes* lote, int suspeitos) {
+    memset(lote, 0, sizeof(*lote));
+    lote->suspeitos = suspeitos;
+    lote->contagens = (BufferBytes*)calloc((size_t)(suspeitos > 0 ? suspeitos : 1), sizeof(BufferBytes));
+    if (lote->contagens == NULL) {
+        perror("Erro na alocação de memória para a exportação");
+        exit(EXIT_FAILURE);
+    }
+    reiniciarLote(lote);
+}
+
+void liberarLote(LoteSessoes* lote) {
+    BufferBytes* colunas[] = { &lote->sessao, &lote->caminhoOffsets, &lote->caminho, &lote->pistasOffsets,
+                               &lote->pistas, &lote->acusado, &lote->pistasAcusado, &lote->veredito };
+    for (size_t i = 0; i < sizeof(colunas) / sizeof(colunas[0]); i++) free(colunas[i]->dados);
+    for (int s = 0; s < lote->suspeitos; s++) free(lote->contagens[s].dados);
+    free(lote->contagens);
+    memset(lote, 0, sizeof(*lote));
+}
+
+// Fecha a linha da sessão: pistas e contagens vêm da sessão do motor
+void anexarSessaoAoLote(LoteSessoes* lote, const MotorExploracao* motor, const SessaoExploracao* sessao,
+                        long long id, int acusado, Veredito veredito) {
+    anexarInteiro(&lote->sessao, (uint64_t)id, 8);
+    anexarInteiro(&lote->caminhoOffsets, lote->caminho.usado / 4, 4);
+    for (int i = 0; i < sessao->coletadas; i++) anexarInteiro(&lote->pistas, (uint32_t)sessao->ordemDaColeta[i], 4);
+    anexarInteiro(&lote->pistasOffsets, lote->pistas.usado / 4, 4);
+    for (int s = 0; s < motor->suspeitos; s++) anexarInteiro(&lote->contagens[s], (uint32_t)sessao->contagem[s], 4);
+    anexarInteiro(&lote->acusado, (uint32_t)acusado, 4);
+    anexarInteiro(&lote->pistasAcusado, (uint32_t)(acusado >= 0 ? sessao->contagem[acusado] : 0), 4);
+    anexarInteiro(&lote->veredito, (uint64_t)veredito, 1);
+    lote->linhas++;
+}
+
+static void escreverColuna(BufferBytes* saida, const char* nome, int tipo, const BufferBytes* offsets, const BufferBytes* dados) {
+    size_t tamanhoNome = strlen(nome);
+    anexarInteiro(saida, (uint64_t)tipo, 1);
+    anexarInteiro(saida, tamanhoNome, 2);
+    anexarBytes(saida, nome, tamanhoNome);
+    anexarInteiro(saida, (offsets != NULL ? offsets->usado : 0) + dados->usado, 8);
+    if (offsets != NULL) anexarBytes(saida, offsets->dados, offsets->usado);
+    anexarBytes(saida, dados->dados, dados->usado);
+}
+
+// Serializa o lote em 'saida' (reaproveitado) e grava de uma vez
+int gravarLote(FILE* arquivo, LoteSessoes* lote, const MotorExploracao* motor, BufferBytes* saida) {
+    saida->usado = 0;
+    anexarBytes(saida, "LOTE", 4);
+    anexarInteiro(saida, 0, 8); // Tamanho, preenchido abaixo
+    anexarInteiro(saida, (uint64_t)lote->linhas, 4);
+    anexarInteiro(saida, (uint64_t)(6 + motor->suspeitos), 4);
+    escreverColuna(saida, "sessao", COLUNA_INT64, NULL, &lote->sessao);
+    escreverColuna(saida, "caminho", COLUNA_LISTA_INT32, &lote->caminhoOffsets, &lote->caminho);
+    escreverColuna(saida, "pistas", COLUNA_LISTA_INT32, &lote->pistasOffsets, &lote->pistas);
+    char nome[MAX_SUSPEITO + 16];
+    for (int s = 0; s < motor->suspeitos; s++) {
+        snprintf(nome, sizeof(nome), "contagem_%s", motor->nomeSuspeito[s]);
+        escreverColuna(saida, nome, COLUNA_INT32, NULL, &lote->contagens[s]);
+    }
+    escreverColuna(saida, "acusado", COLUNA_INT32, NULL, &lote->acusado);
+    escreverColuna(saida, "pistas_acusado", COLUNA_INT32, NULL, &lote->pistasAcusado);
+    escreverColuna(saida, "veredito", COLUNA_UINT8, NULL, &lote->veredito);
+    uint64_t restante = saida->usado - 12;
+    for (int i = 0; i < 8; i++) saida->dados[4 + i] = (unsigned char)(restante >> (8 * i));
+    return fwrite(saida->dados, 1, saida->usado, arquivo) == saida->usado ? 0 : -1;
+}
+
+// Dicionário do arquivo: suspeitos e, por cômodo, nome, suspeito e texto da pista
+int gravarCabecalhoColunar(FILE* arquivo, const MotorExploracao* motor, const ArmazemPistas* armazem) {
+    BufferBytes saida = { NULL, 0, 0 };
+    anexarBytes(&saida, "DMCOLUN1", 8);
+    anexarInteiro(&saida, VERSAO_COLUNAR, 4);
+    anexarInteiro(&saida, (uint64_t)motor->suspeitos, 4);
+    for (int s = 0; s < motor->suspeitos; s++) {
+        size_t tamanho = strlen(motor->nomeSuspeito[s]);
+        anexarInteiro(&saida, tamanho, 2);
+        anexarBytes(&saida, motor->nomeSuspeito[s], tamanho);
+    }
+    anexarInteiro(&saida, (uint64_t)motor->quantidade, 4);
+    for (int id = 0; id < motor->quantidade; id++) {
+        const ComodoIndexado* comodo = &motor->mapa->comodos[id];
+        size_t tamanho = strlen(comodo->nome);
+        anexarInteiro(&saida, tamanho, 2);
+        anexarBytes(&saida, comodo->nome, tamanho);
+        anexarInteiro(&saida, (uint32_t)motor->suspeitoDe[id], 4);
+        size_t texto = comprimentoPista(armazem, comodo->pista);
+        anexarInteiro(&saida, texto, 4);
+        // Descomprime direto no buffer (com folga para a cópia de 8 em 8 bytes)
+        char* destino = (char*)reservarBytes(&saida, texto + TAM_SIMBOLO + 1);
+        decodificarPista(armazem, comodo->pista, destino, texto + TAM_SIMBOLO + 1);
+        saida.usado += texto;
+    }
+    int resultado = fwrite(saida.dados, 1, saida.usado, arquivo) == saida.usado ? 0 : -1;
+    free(saida.dados);
+    return resultado;
+}
+
+// Joga 'total' sessões aleatórias com o motor e as exporta, um lote por vez.
+// Cada sessão desce da raiz escolhendo E/D e pode parar antes de uma folha;
+// a acusação vai para o suspeito com mais pistas coletadas.
+int exportarSessoes(const char* caminho, long long total, int comodos, int linhasPorLote) {
+    if (linhasPorLote <= 0) linhasPorLote = LINHAS_POR_LOTE;
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = comodos > 0 ? gerarMansao(comodos, 31337u, &armazem) : montarMapa(&armazem);
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    MotorExploracao motor;
+    prepararMotor(&motor, &mapa, &armazem);
+    SessaoExploracao sessao;
+    criarSessaoExploracao(&sessao, &motor);
+
+    FILE* arquivo = fopen(caminho, "wb");
+    if (arquivo == NULL) {
+        perror("Erro ao criar o arquivo de exportação");
+        return 1;
+    }
+    setvbuf(arquivo, NULL, _IOFBF, 1 << 20);
+
+    struct timespec inicio;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    int erro = gravarCabecalhoColunar(arquivo, &motor, &armazem);
+
+    LoteSessoes lote;
+    inicializarLote(&lote, motor.suspeitos);
+    BufferBytes saida = { NULL, 0, 0 };
+    BufferBytes deslocamentos = { NULL, 0, 0 };
+    unsigned int estado = 1234u;
+    int lotes = 0;
+
+    for (long long id = 0; id < total && !erro; id++) {
+        reiniciarSessaoExploracao(&sessao, &motor);
+        int atual = 0;
+        while (1) {
+            entrarComodo(&motor, &sessao, atual);
+            anexarInteiro(&lote.caminho, (uint32_t)atual, 4);
+            int filhos[2] = { mapa.comodos[atual].esquerda, mapa.comodos[atual].direita };
+            unsigned int sorteio = proximoAleatorio(&estado);
+            if ((filhos[0] < 0 && filhos[1] < 0) || (sorteio & 7) == 0) break; // Folha ou [F]inalizar
+            int lado = (int)((sorteio >> 3) & 1);
+            atual = filhos[lado] >= 0 ? filhos[lado] : filhos[1 - lado];
+        }
+
+        int acusado = -1;
+        for (int s = 0; s < motor.suspeitos; s++) {
+            if (sessao.contagem[s] > 0 && (acusado < 0 || sessao.contagem[s] > sessao.contagem[acusado])) acusado = s;
+        }
+        int pistas = acusado >= 0 ? sessao.contagem[acusado] : 0;
+        anexarSessaoAoLote(&lote, &motor, &sessao, id, acusado, classificarVeredito(pistas));
+
+        if (lote.linhas == linhasPorLote || id == total - 1) {
+            anexarInteiro(&deslocamentos, (uint64_t)ftello(arquivo), 8);
+            erro = gravarLote(arquivo, &lote, &motor, &saida);
+            reiniciarLote(&lote);
+            lotes++;
+        }
+    }
+
+    // Rodapé: deslocamento de cada lote para leitura aleatória
+    if (!erro) {
+        anexarInteiro(&deslocamentos, (uint64_t)lotes, 4);
+        anexarInteiro(&deslocamentos, (uint64_t)total, 8);
+        anexarBytes(&deslocamentos, "FIMCOLUN", 8);
+        erro = fwrite(deslocamentos.dados, 1, deslocamentos.usado, arquivo) != deslocamentos.usado;
+    }
+    long long bytes = (long long)ftello(arquivo);
+    if (fclose(arquivo) != 0) erro = 1;
+    if (erro) perror("Erro ao gravar o arquivo de exportação");
+    else printf("%lld sessões exportadas em %d lotes (%lld bytes, %.1f bytes/sessão) em %.3f s\n",
+                total, lotes, bytes, total > 0 ? (double)bytes / (double)total : 0.0, segundosDesde(&inicio));
+
+    free(saida.dados);
+    free(deslocamentos.dados);
+    liberarLote(&lote);
+    liberarSessaoExploracao(&sessao);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return erro ? 1 : 0;
+}
+
+// Lê exatamente 'tamanho' bytes para o buffer (reaproveitado); NULL em EOF/erro
+static unsigned char* lerBloco(FILE* arquivo, BufferBytes* buffer, size_t tamanho) {
+    buffer->usado = 0;
+    unsigned char* destino = reservarBytes(buffer, tamanho > 0 ? tamanho : 1);
+    return fread(destino, 1, tamanho, arquivo) == tamanho ? destino : NULL;
+}
+
+// Lê o dicionário: guarda os nomes dos suspeitos e pula os cômodos
+static int lerCabecalhoColunar(FILE* arquivo, BufferBytes* buffer, char*** suspeitos, int* quantidade) {
+    unsigned char* p = lerBloco(arquivo, buffer, 16);
+    if (p == NULL || memcmp(p, "DMCOLUN1", 8) != 0 || lerInteiro(p + 8, 4) != VERSAO_COLUNAR) return -1;
+    *quantidade = (int)lerInteiro(p + 12, 4);
+    *suspeitos = (char**)calloc((size_t)*quantidade + 1, sizeof(char*));
+    if (*suspeitos == NULL) return -1;
+    for (int s = 0; s < *quantidade; s++) {
+        if ((p = lerBloco(arquivo, buffer, 2)) == NULL) return -1;
+        size_t tamanho = (size_t)lerInteiro(p, 2);
+        if ((p = lerBloco(arquivo, buffer, tamanho)) == NULL) return -1;
+        (*suspeitos)[s] = (char*)calloc(tamanho + 1, 1);
+        if ((*suspeitos)[s] == NULL) return -1;
+        memcpy((*suspeitos)[s], p, tamanho);
+    }
+    if ((p = lerBloco(arquivo, buffer, 4)) == NULL) return -1;
+    int comodos = (int)lerInteiro(p, 4);
+    for (int id = 0; id < comodos; id++) {
+        if ((p = lerBloco(arquivo, buffer, 2)) == NULL || fseeko(arquivo, (off_t)lerInteiro(p, 2) + 4, SEEK_CUR) != 0) return -1;
+        if ((p = lerBloco(arquivo, buffer, 4)) == NULL || fseeko(arquivo, (off_t)lerInteiro(p, 4), SEEK_CUR) != 0) return -1;
+    }
+    return 0;
+}
+
+// Colunas de um lote já carregado em memória
+typedef struct ColunasLote {
+    int linhas;
+    const unsigned char *caminho, *pistas;   // Offsets das listas (linhas + 1)
+    const unsigned char *acusado, *pistasAcusado, *veredito;
+    const unsigned char** contagens;         // Por suspeito (NULL se ausente)
+} ColunasLote;
+
+// Procura as colunas pelo nome, conferindo os tamanhos; colunas desconhecidas
+// são ignoradas. Retorna -1 se o lote estiver malformado.
+static int localizarColunas(const unsigned char* dados, size_t tamanho, char** suspeitos, int quantidadeSuspeitos, ColunasLote* colunas) {
+    if (tamanho < 8) return -1;
+    size_t linhas = (size_t)lerInteiro(dados, 4);
+    int quantidade = (int)lerInteiro(dados + 4, 4);
+    colunas->linhas = (int)linhas;
+    colunas->caminho = colunas->pistas = colunas->acusado = colunas->pistasAcusado = colunas->veredito = NULL;
+    for (int s = 0; s < quantidadeSuspeitos; s++) colunas->contagens[s] = NULL;
+
+    size_t pos = 8;
+    for (int c = 0; c < quantidade; c++) {
+        if (pos + 3 > tamanho) return -1;
+        int tipo = dados[pos];
+        size_t tamanhoNome = (size_t)lerInteiro(dados + pos + 1, 2);
+        if (pos + 3 + tamanhoNome + 8 > tamanho) return -1;
+        const char* nome = (const char*)dados + pos + 3;
+        size_t bytes = (size_t)lerInteiro(dados + pos + 3 + tamanhoNome, 8);
+        const unsigned char* valores = dados + pos + 3 + tamanhoNome + 8;
+        pos += 3 + tamanhoNome + 8;
+        if (bytes > tamanho - pos) return -1;
+        pos += bytes;
+
+        size_t esperado = tipo == COLUNA_INT64 ? linhas * 8 : tipo == COLUNA_INT32 ? linhas * 4 : tipo == COLUNA_UINT8 ? linhas : (linhas + 1) * 4;
+        if (tipo == COLUNA_LISTA_INT32 ? bytes < esperado : bytes != esperado) return -1;
+#define NOME_E(literal) (tamanhoNome == sizeof(literal) - 1 && memcmp(nome, literal, tamanhoNome) == 0)
+        if (NOME_E("caminho") && tipo == COLUNA_LISTA_INT32) colunas->caminho = valores;
+        else if (NOME_E("pistas") && tipo == COLUNA_LISTA_INT32) colunas->pistas = valores;
+        else if (NOME_E("acusado") && tipo == COLUNA_INT32) colunas->acusado = valores;
+        else if (NOME_E("pistas_acusado") && tipo == COLUNA_INT32) colunas->pistasAcusado = valores;
+        else if (NOME_E("veredito") && tipo == COLUNA_UINT8) colunas->veredito = valores;
+        else if (tamanhoNome > 9 && memcmp(nome, "contagem_", 9) == 0 && tipo == COLUNA_INT32) {
+            for (int s = 0; s < quantidadeSuspeitos; s++) {
+                if (strlen(suspeitos[s]) == tamanhoNome - 9 && memcmp(nome + 9, suspeitos[s], tamanhoNome - 9) == 0) {
+                    colunas->contagens[s] = valores;
+                }
+            }
+        }
+#undef NOME_E
+    }
+    return colunas->caminho && colunas->pistas && colunas->acusado && colunas->pistasAcusado && colunas->veredito ? 0 : -1;
+}
+
+// Lê um arquivo exportado lote a lote, confere a consistência entre as colunas
+// (o veredito gravado tem de ser o de classificarVeredito para o acusado)
+// e resume: vereditos, tamanho médio do caminho e pistas por suspeito.
+int lerSessoesExportadas(const char* caminho) {
+    FILE* arquivo = fopen(caminho, "rb");
+    if (arquivo == NULL) {
+        perror("Erro ao abrir o arquivo exportado");
+        return 1;
+    }
+    BufferBytes buffer = { NULL, 0, 0 };
+    BufferBytes lote = { NULL, 0, 0 };
+    char** suspeitos = NULL;
+    int quantidadeSuspeitos = 0;
+    int valido = lerCabecalhoColunar(arquivo, &buffer, &suspeitos, &quantidadeSuspeitos) == 0;
+
+    long long* pistasPorSuspeito = (long long*)calloc((size_t)quantidadeSuspeitos + 1, sizeof(long long));
+    ColunasLote colunas;
+    colunas.contagens = (const unsigned char**)calloc((size_t)quantidadeSuspeitos + 1, sizeof(char*));
+    if (pistasPorSuspeito == NULL || colunas.contagens == NULL) {
+        perror("Erro na alocação de memória para a leitura");
+        exit(EXIT_FAILURE);
+    }
+
+    long long sessoes = 0, passos = 0, inconsistentes = 0;
+    long long vereditos[VEREDITO_SUSTENTAVEL + 1] = { 0 };
+    int lotes = 0;
+    while (valido) {
+        unsigned char* p = lerBloco(arquivo, &buffer, 4);
+        if (p == NULL) {
+            valido = 0;
+            break;
+        }
+        if (memcmp(p, "LOTE", 4) != 0) break; // Início do rodapé
+        if ((p = lerBloco(arquivo, &buffer, 8)) == NULL) {
+            valido = 0;
+            break;
+        }
+        size_t bytes = (size_t)lerInteiro(p, 8);
+        if ((p = lerBloco(arquivo, &lote, bytes)) == NULL ||
+            localizarColunas(p, bytes, suspeitos, quantidadeSuspeitos, &colunas) != 0) {
+            valido = 0;
+            break;
+        }
+
+        for (int i = 0; i < colunas.linhas; i++) {
+            int tamanhoCaminho = (int)(lerInteiro(colunas.caminho + 4 * (i + 1), 4) - lerInteiro(colunas.caminho + 4 * i, 4));
+            int pistas = (int)(lerInteiro(colunas.pistas + 4 * (i + 1), 4) - lerInteiro(colunas.pistas + 4 * i, 4));
+            int somaContagens = 0;
+            for (int s = 0; s < quantidadeSuspeitos; s++) {
+                int contagem = colunas.contagens[s] != NULL ? (int)lerInteiro(colunas.contagens[s] + 4 * i, 4) : 0;
+                somaContagens += contagem;
+                pistasPorSuspeito[s] += contagem;
+            }
+            int acusado = (int)(int32_t)lerInteiro(colunas.acusado + 4 * i, 4);
+            int contraAcusado = (int)lerInteiro(colunas.pistasAcusado + 4 * i, 4);
+            int esperado = acusado >= 0 && acusado < quantidadeSuspeitos && colunas.contagens[acusado] != NULL
+                               ? (int)lerInteiro(colunas.contagens[acusado] + 4 * i, 4) : 0;
+            Veredito veredito = classificarVeredito(contraAcusado);
+            if (somaContagens != pistas || contraAcusado != esperado || colunas.veredito[i] != veredito) inconsistentes++;
+            else vereditos[veredito]++;
+            passos += tamanhoCaminho;
+        }
+        sessoes += colunas.linhas;
+        lotes++;
+    }
+
+    // Rodapé: confere o total de lotes e de linhas
+    unsigned char* rodape = NULL;
+    if (valido && (fseeko(arquivo, -20, SEEK_END) != 0 || (rodape = lerBloco(arquivo, &buffer, 20)) == NULL ||
+                   memcmp(rodape + 12, "FIMCOLUN", 8) != 0 || (int)lerInteiro(rodape, 4) != lotes ||
+                   (long long)lerInteiro(rodape + 4, 8) != sessoes)) {
+        valido = 0;
+    }
+
+    if (!valido) {
+        printf("Arquivo inválido ou truncado: %s\n", caminho);
+    } else {
+        printf("%lld sessões em %d lotes | caminho médio: %.2f cômodos | linhas inconsistentes: %lld\n",
+               sessoes, lotes, sessoes > 0 ? (double)passos / (double)sessoes : 0.0, inconsistentes);
+        for (int v = 0; v <= VEREDITO_SUSTENTAVEL; v++) printf("  %-13s %lld\n", NOMES_VEREDITO[v], vereditos[v]);
+        printf("Pistas coletadas por suspeito:\n");
+        for (int s = 0; s < quantidadeSuspeitos; s++) printf("  %-20s %lld\n", suspeitos[s], pistasPorSuspeito[s]);
+    }
+
+    if (suspeitos != NULL) {
+        for (int s = 0; s < quantidadeSuspeitos; s++) free(suspeitos[s]);
+    }
+    free(suspeitos);
+    free(pistasPorSuspeito);
+    free(colunas.contagens);
+    free(buffer.dados);
+    free(lote.dados);
+    fclose(arquivo);
+    return valido && inconsistentes == 0 ? 0 : 1;
+}
+
+// -------------------------------------------------------------------
+// 16. MANSÕES ESTÁTICAS (TABELAS GERADAS)
+// -------------------------------------------------------------------
+
+// Casos fixos são compilados junto com o jogo: o gerador abaixo transforma uma
+// mansão (a de demonstração ou uma planta em árvore) num cabeçalho com
+// inicializadores constantes. Textos e dicionário das pistas, cômodos em
+// pré-ordem (ComodoIndexado), o índice do mapa, o motor de exploração e o
+// resumo inicial por subárvore ficam em .rodata, exatamente como indexarMapa,
+// prepararMotor e prepararResumo os montariam: a partida não constrói nada,
+// só copia o resumo, que é o seu estado. Mansões carregadas em tempo de
+// execução continuam passando pelo mesmo motor.
+//
+// O cabeçalho é gerado por este mesmo programa. Sem ele, ou com um cabeçalho
+// de uma versão anterior das estruturas, compile com -DSEM_MANSAO_DEMO: o jogo
+// volta a montar a mansão com montarMapa, e --gerar-tabela recria o arquivo.
+#if !defined(SEM_MANSAO_DEMO) && defined(__has_include)
+#if __has_include("mansao_demo.h")
+#include "mansao_demo.h"
+#define TEM_MANSAO_DEMO 1
+#endif
+#endif
+#ifndef TEM_MANSAO_DEMO
+#define TEM_MANSAO_DEMO 0
+#endif
+
+// Escreve 'texto' como literal C (aspas, barras e controles escapados em octal)
+static void escreverLiteralC(FILE* saida, const char* texto) {
+    fputc('"', saida);
+    for (const unsigned char* p = (const unsigned char*)texto; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') fprintf(saida, "\\%c", *p);
+        else if (*p < 0x20 || *p == 0x7f) fprintf(saida, "\\%03o", *p);
+        else fputc(*p, saida);
+    }
+    fputc('"', saida);
+}
+
+// Vetor de inteiros (unsigned char, short ou uint32_t, conforme 'bytes'), 12 por linha
+static void escreverVetorC(FILE* saida, const char* tipo, const char* prefixo, const char* nome,
+                           const void* dados, size_t quantidade, int bytes) {
+    fprintf(saida, "static const %s %s_%s[%zu] = {", tipo, prefixo, nome, quantidade > 0 ? quantidade : 1);
+    for (size_t i = 0; i < quantidade; i++) {
+        long valor = bytes == 1   ? (long)((const unsigned char*)dados)[i]
+                     : bytes == 2 ? (long)((const short*)dados)[i]
+                                  : (long)((const uint32_t*)dados)[i];
+        fprintf(saida, "%s%ld,", i % 12 == 0 ? "\n    " : " ", valor);
+    }
+    fprintf(saida, "%s};\n\n", quantidade > 0 ? "\n" : "0");
+}
+
+// Vetor de int (ids e contagens, -1 quando não há), 12 por linha
+static void escreverInteirosC(FILE* saida, const char* prefixo, const char* nome, const int* dados, size_t quantidade) {
+    fprintf(saida, "static const int %s_%s[%zu] = {", prefixo, nome, quantidade > 0 ? quantidade : 1);
+    for (size_t i = 0; i < quantidade; i++) fprintf(saida, "%s%d,", i % 12 == 0 ? "\n    " : " ", dados[i]);
+    fprintf(saida, "%s};\n\n", quantidade > 0 ? "\n" : "0");
+}
+
+// Símbolos do dicionário como matriz [simbolos][TAM_SIMBOLO], um por linha
+static void escreverSimbolosC(FILE* saida, const char* prefixo, const ArmazemPistas* armazem) {
+    fprintf(saida, "static const unsigned char %s_SIMBOLO[%d][TAM_SIMBOLO] = {\n", prefixo, armazem->simbolos);
+    for (int c = 0; c < armazem->simbolos; c++) {
+        fprintf(saida, "    {");
+        for (int i = 0; i < TAM_SIMBOLO; i++) fprintf(saida, "%s%d", i > 0 ? ", " : " ", armazem->simbolo[c][i]);
+        fprintf(saida, " },\n");
+    }
+    fprintf(saida, "};\n\n");
+}
+
+// O prefixo vira nome de macros e vetores: precisa ser um identificador C
+static int identificadorC(const char* texto) {
+    if (!isalpha((unsigned char)texto[0]) && texto[0] != '_') return 0;
+    for (const char* p = texto; *p != '\0'; p++) {
+        if (!isalnum((unsigned char)*p) && *p != '_') return 0;
+    }
+    return 1;
+}
+
+// Gera o cabeçalho com a mansão 'origem' ("demo" ou uma planta em árvore)
+int gerarTabelaMansao(const char* origem, const char* caminhoSaida, const char* prefixo) {
+    if (!identificadorC(prefixo)) {
+        printf("Prefixo inválido: '%s' (use letras, dígitos e '_', sem começar por dígito)\n", prefixo);
+        return 1;
+    }
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = NULL;
+    if (strcmp(origem, "demo") == 0) {
+        mansao = montarMapa(&armazem);
+    } else {
+        GrafoMansao grafo;
+        if (carregarGrafo(origem, &grafo, &armazem) != 0) {
+            liberarArmazem(&armazem);
+            return 1;
+        }
+        mansao = exportarArvore(&grafo, 0);
+        liberarGrafo(&grafo);
+        if (mansao == NULL) {
+            printf("A planta '%s' não é uma árvore binária (passagens E/D a partir da primeira sala).\n", origem);
+            liberarArmazem(&armazem);
+            return 1;
+        }
+    }
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    MotorExploracao motor;
+    prepararMotor(&motor, &mapa, &armazem);
+    ResumoSubarvores resumo;
+    prepararResumo(&resumo, &mapa, &motor);
+
+    FILE* saida = fopen(caminhoSaida, "w");
+    if (saida == NULL) {
+        perror("Erro ao criar o cabeçalho da mansão");
+        liberarResumo(&resumo);
+        liberarMotor(&motor);
+        liberarMapaIndexado(&mapa);
+        liberarMapa(mansao);
+        liberarArmazem(&armazem);
+        return 1;
+    }
+
+    // Sem o caminho de saída: gerar de novo em outro lugar e comparar com
+    // 'diff' mostra se o cabeçalho do repositório está defasado
+    fprintf(saida, "// Gerado por: ./mestre --gerar-tabela %s <saída> %s\n", origem, prefixo);
+    fprintf(saida, "// Não edite à mão: altere a mansão de origem e gere de novo.\n");
+    fprintf(saida, "#ifndef %s_H\n#define %s_H\n\n", prefixo, prefixo);
+
+    // 1. Armazém de pistas: textos comprimidos e dicionário, somente leitura
+    fprintf(saida, "// Textos comprimidos das pistas\n");
+    escreverVetorC(saida, "uint32_t", prefixo, "INICIO", armazem.inicio, (size_t)armazem.quantidade + 1, 4);
+    escreverVetorC(saida, "uint32_t", prefixo, "COMPRIMENTO", armazem.comprimento, (size_t)armazem.quantidade, 4);
+    escreverVetorC(saida, "unsigned char", prefixo, "DADOS", armazem.dados, armazem.usado, 1);
+
+    // Dicionário só quando o treino o manteve (casos pequenos ficam literais)
+    if (armazem.simbolos > 0) {
+        fprintf(saida, "// Dicionário (%d símbolos)\n", armazem.simbolos);
+        escreverVetorC(saida, "unsigned char", prefixo, "TAMANHO_SIMBOLO", armazem.tamanhoSimbolo,
+                       (size_t)armazem.simbolos, 1);
+        escreverSimbolosC(saida, prefixo, &armazem);
+        escreverVetorC(saida, "short", prefixo, "PRIMEIRO_POR_BYTE", armazem.primeiroPorByte, 256, 2);
+        escreverVetorC(saida, "short", prefixo, "PROXIMO_MESMO_BYTE", armazem.proximoMesmoByte,
+                       (size_t)armazem.simbolos, 2);
+    }
+
+    fprintf(saida, "// Capacidades zeradas: armazém fixo, não recebe pistas novas\n");
+    fprintf(saida, "static const ArmazemPistas %s_ARMAZEM = {\n", prefixo);
+    fprintf(saida, "    .simbolos = %d,\n    .treinado = %d,\n", armazem.simbolos, armazem.treinado);
+    if (armazem.simbolos > 0) {
+        fprintf(saida, "    .tamanhoSimbolo = %s_TAMANHO_SIMBOLO,\n", prefixo);
+        fprintf(saida, "    .simbolo = %s_SIMBOLO,\n", prefixo);
+        fprintf(saida, "    .primeiroPorByte = %s_PRIMEIRO_POR_BYTE,\n", prefixo);
+        fprintf(saida, "    .proximoMesmoByte = %s_PROXIMO_MESMO_BYTE,\n", prefixo);
+    }
+    fprintf(saida, "    .quantidade = %d,\n", armazem.quantidade);
+    fprintf(saida, "    .inicio = %s_INICIO,\n", prefixo);
+    fprintf(saida, "    .comprimento = %s_COMPRIMENTO,\n", prefixo);
+    fprintf(saida, "    .dados = %s_DADOS,\n", prefixo);
+    fprintf(saida, "    .usado = %zu,\n};\n\n", armazem.usado);
+
+    // 2. Cômodos em pré-ordem: o índice é o id, e os filhos são ids
+    size_t n = (size_t)mapa.quantidade;
+    fprintf(saida, "// Cômodos em pré-ordem (raiz no id 0); filhos por id, -1 se não houver\n");
+    fprintf(saida, "#define %s_QUANTIDADE %d\n\n", prefixo, mapa.quantidade);
+    fprintf(saida, "static const ComodoIndexado %s_COMODOS[%zu] = {\n", prefixo, n > 0 ? n : 1);
+    for (int id = 0; id < mapa.quantidade; id++) {
+        const ComodoIndexado* comodo = &mapa.comodos[id];
+        fprintf(saida, "    [%d] = { .nome = ", id);
+        escreverLiteralC(saida, comodo->nome);
+        fprintf(saida, ", .pista = %d, .suspeito_associado = ", comodo->pista);
+        escreverLiteralC(saida, comodo->suspeito_associado);
+        fprintf(saida, ", .esquerda = %d, .direita = %d },\n", comodo->esquerda, comodo->direita);
+    }
+    fprintf(saida, "};\n\n");
+
+    // 3. Índice do mapa, como indexarMapa o montaria
+    fprintf(saida, "// Mapa indexado (seção 8): pai, profundidade, fim da subárvore, ordem por nome e\n");
+    fprintf(saida, "// tabela esparsa (%d níveis)\n", mapa.niveis);
+    escreverInteirosC(saida, prefixo, "PAI", mapa.pai, n);
+    escreverInteirosC(saida, prefixo, "PROFUNDIDADE", mapa.profundidade, n);
+    escreverInteirosC(saida, prefixo, "FIM_SUBARVORE", mapa.fimSubarvore, n);
+    escreverInteirosC(saida, prefixo, "POR_NOME", mapa.porNome, n);
+    escreverInteirosC(saida, prefixo, "ESPARSA", mapa.esparsa, (size_t)mapa.niveis * n);
+    fprintf(saida, "// Sem 'bloco': liberarMapaIndexado não libera nada\n");
+    fprintf(saida, "static const MapaIndexado %s_MAPA = {\n", prefixo);
+    fprintf(saida, "    .quantidade = %s_QUANTIDADE,\n    .comodos = %s_COMODOS,\n", prefixo, prefixo);
+    fprintf(saida, "    .pai = %s_PAI,\n    .profundidade = %s_PROFUNDIDADE,\n", prefixo, prefixo);
+    fprintf(saida, "    .fimSubarvore = %s_FIM_SUBARVORE,\n    .porNome = %s_POR_NOME,\n", prefixo, prefixo);
+    fprintf(saida, "    .niveis = %d,\n    .esparsa = %s_ESPARSA,\n};\n\n", mapa.niveis, prefixo);
+
+    // 4. Motor de exploração, como prepararMotor o montaria
+    fprintf(saida, "// Motor de exploração (seção 12): %d pistas, %d textos distintos, %d suspeitos\n",
+            motor.totalPistas, motor.pistasDistintas, motor.suspeitos);
+    escreverVetorC(saida, "unsigned char", prefixo, "TEM_PISTA", motor.temPista, n, 1);
+    escreverInteirosC(saida, prefixo, "INDICE_PISTA", motor.indicePista, n);
+    escreverInteirosC(saida, prefixo, "ORDEM_PISTA", motor.ordemPista, n);
+    escreverInteirosC(saida, prefixo, "SUSPEITO_DE", motor.suspeitoDe, n);
+    fprintf(saida, "static const char* const %s_NOME_SUSPEITO[%d] = {", prefixo, motor.suspeitos > 0 ? motor.suspeitos : 1);
+    for (int i = 0; i < motor.suspeitos; i++) {
+        fprintf(saida, "\n    ");
+        escreverLiteralC(saida, motor.nomeSuspeito[i]);
+        fprintf(saida, ",");
+    }
+    fprintf(saida, "%s};\n\n", motor.suspeitos > 0 ? "\n" : "0");
+    fprintf(saida, "static const MotorExploracao %s_MOTOR = {\n", prefixo);
+    fprintf(saida, "    .mapa = &%s_MAPA,\n    .quantidade = %s_QUANTIDADE,\n", prefixo, prefixo);
+    fprintf(saida, "    .temPista = %s_TEM_PISTA,\n    .indicePista = %s_INDICE_PISTA,\n", prefixo, prefixo);
+    fprintf(saida, "    .ordemPista = %s_ORDEM_PISTA,\n    .suspeitoDe = %s_SUSPEITO_DE,\n", prefixo, prefixo);
+    fprintf(saida, "    .totalPistas = %d,\n    .pistasDistintas = %d,\n", motor.totalPistas, motor.pistasDistintas);
+    fprintf(saida, "    .suspeitos = %d,\n    .nomeSuspeito = %s_NOME_SUSPEITO,\n};\n\n", motor.suspeitos, prefixo);
+
+    // 5. Resumo por subárvore com nenhuma pista coletada: o único estado da partida
+    fprintf(saida, "// Resumo por subárvore (seção 13) sem nenhuma pista coletada: cada partida o copia\n");
+    escreverInteirosC(saida, prefixo, "RESTANTES", resumo.restantes, n * (size_t)motor.suspeitos);
+    escreverInteirosC(saida, prefixo, "TOTAL_RESTANTE", resumo.totalRestante, n);
+    fprintf(saida, "#endif // %s_H\n", prefixo);
+
+    int erro = ferror(saida) != 0;
+    if (fclose(saida) != 0 || erro) {
+        perror("Erro ao gravar o cabeçalho da mansão");
+        erro = 1;
+    } else {
+        printf("%s gerado: %d cômodos, %d pistas (%zu bytes comprimidos), prefixo %s\n",
+               caminhoSaida, mapa.quantidade, armazem.quantidade, armazem.usado, prefixo);
+    }
+    liberarResumo(&resumo);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return erro;
+}
+
+// Confere se a tabela compilada ainda corresponde a montarMapa: cômodos,
+// texto das pistas e tudo o que indexarMapa, prepararMotor e prepararResumo
+// montariam. Falha se o cabeçalho estiver defasado ou se o programa foi
+// compilado sem ele.
+int conferirMansaoEstatica(void) {
+#if TEM_MANSAO_DEMO
+    ArmazemPistas armazem;
+    inicializarArmazem(&armazem);
+    Comodo* mansao = montarMapa(&armazem);
+    MapaIndexado mapa;
+    indexarMapa(&mapa, mansao);
+    MotorExploracao motor;
+    prepararMotor(&motor, &mapa, &armazem);
+    ResumoSubarvores resumo;
+    prepararResumo(&resumo, &mapa, &motor);
+    const MapaIndexado* tabela = &MANSAO_DEMO_MAPA;
+    const MotorExploracao* motorTabela = &MANSAO_DEMO_MOTOR;
+    const ArmazemPistas* estatico = &MANSAO_DEMO_ARMAZEM;
+
+    // 1. Índice, motor e resumo inicial: os mesmos vetores, posição a posição
+    size_t n = (size_t)mapa.quantidade;
+    size_t s = (size_t)motor.suspeitos;
+    int iguais = tabela->quantidade == mapa.quantidade && tabela->niveis == mapa.niveis &&
+                 motorTabela->mapa == tabela && motorTabela->quantidade == motor.quantidade &&
+                 motorTabela->totalPistas == motor.totalPistas &&
+                 motorTabela->pistasDistintas == motor.pistasDistintas && motorTabela->suspeitos == motor.suspeitos;
+    iguais = iguais && memcmp(tabela->pai, mapa.pai, sizeof(int) * n) == 0 &&
+             memcmp(tabela->profundidade, mapa.profundidade, sizeof(int) * n) == 0 &&
+             memcmp(tabela->fimSubarvore, mapa.fimSubarvore, sizeof(int) * n) == 0 &&
+             memcmp(tabela->porNome, mapa.porNome, sizeof(int) * n) == 0 &&
+             memcmp(tabela->esparsa, mapa.esparsa, sizeof(int) * n * (size_t)mapa.niveis) == 0;
+    iguais = iguais && memcmp(motorTabela->temPista, motor.temPista, n) == 0 &&
+             memcmp(motorTabela->indicePista, motor.indicePista, sizeof(int) * n) == 0 &&
+             memcmp(motorTabela->ordemPista, motor.ordemPista, sizeof(int) * n) == 0 &&
+             memcmp(motorTabela->suspeitoDe, motor.suspeitoDe, sizeof(int) * n) == 0 &&
+             memcmp(MANSAO_DEMO_RESTANTES, resumo.restantes, sizeof(int) * n * s) == 0 &&
+             memcmp(MANSAO_DEMO_TOTAL_RESTANTE, resumo.totalRestante, sizeof(int) * n) == 0;
+    for (size_t i = 0; iguais && i < s; i++) iguais = strcmp(motorTabela->nomeSuspeito[i], motor.nomeSuspeito[i]) == 0;
+
+    // 2. Cômodos e texto das pistas (os ids no armazém podem diferir, o texto não)
+    for (int id = 0; iguais && id < mapa.quantidade; id++) {
+        const ComodoIndexado* esperado = &mapa.comodos[id];
+        const ComodoIndexado* comodo = &tabela->comodos[id];
+        char a[512], b[512];
+        iguais = strcmp(esperado->nome, comodo->nome) == 0 &&
+                 strcmp(esperado->suspeito_associado, comodo->suspeito_associado) == 0 &&
+                 esperado->esquerda == comodo->esquerda && esperado->direita == comodo->direita &&
+                 (esperado->pista == SEM_PISTA) == (comodo->pista == SEM_PISTA) &&
+                 comodo->pista < estatico->quantidade;
+        if (iguais && comodo->pista != SEM_PISTA) {
+            iguais = decodificarPista(&armazem, esperado->pista, a, sizeof(a)) ==
+                         decodificarPista(estatico, comodo->pista, b, sizeof(b)) &&
+                     strcmp(a, b) == 0;
+        }
+    }
+    if (iguais) printf("OK: a tabela estática (%d cômodos) corresponde a montarMapa.\n", MANSAO_DEMO_QUANTIDADE);
+    else printf("FALHA: mansao_demo.h está defasado; rode ./mestre --gerar-tabela demo mansao_demo.h MANSAO_DEMO\n");
+
+    liberarResumo(&resumo);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(mansao);
+    liberarArmazem(&armazem);
+    return iguais ? 0 : 1;
+#else
+    printf("FALHA: compilado sem mansao_demo.h; rode ./mestre --gerar-tabela demo mansao_demo.h MANSAO_DEMO "
+           "e compile de novo\n");
+    return 1;
+#endif
+}
+
+// Mansão do jogo interativo, pronta para a partida. Com a tabela compilada,
+// mapa e motor são cópias das constantes do cabeçalho (os vetores ficam em
+// .rodata) e só o resumo, o estado das pistas coletadas, é alocado. Sem o
+// cabeçalho, tudo é montado a partir de montarMapa (em 'armazem'). Retorna o
+// armazém das pistas; '*montada' recebe o que deve ir para liberarMapa no fim
+// (NULL com a tabela). Libere com liberarResumo, liberarMotor e
+// liberarMapaIndexado, como qualquer mansão indexada.
+const ArmazemPistas* abrirMansaoDemo(MapaIndexado* mapa, MotorExploracao* motor, ResumoSubarvores* resumo,
+                                     ArmazemPistas* armazem, Comodo** montada) {
+    inicializarArmazem(armazem);
+#if TEM_MANSAO_DEMO
+    *montada = NULL;
+    *mapa = MANSAO_DEMO_MAPA;
+    *motor = MANSAO_DEMO_MOTOR;
+    motor->mapa = mapa;
+    prepararResumoDeTabela(resumo, mapa, motor, MANSAO_DEMO_RESTANTES, MANSAO_DEMO_TOTAL_RESTANTE);
+    return &MANSAO_DEMO_ARMAZEM;
+#else
+    *montada = montarMapa(armazem);
+    indexarMapa(mapa, *montada);
+    prepararMotor(motor, mapa, armazem);
+    prepararResumo(resumo, mapa, motor);
+    return armazem;
+#endif
+}
+
+// -------------------------------------------------------------------
+// 17. FUNÇÃO PRINCIPAL
+// -------------------------------------------------------------------
+
+// Lista dos modos utilitários (mesma ordem do README)
+void exibirUso(void) {
+    printf("Uso: ./mestre [modo]\n");
+    printf("  (sem modo)                                 jogo interativo\n");
+    printf("  --gerar-tabela <demo|planta> <saída.h> <PREFIXO>\n");
+    printf("  --conferir-tabela\n");
+    printf("  --rota <cômodo de origem> <cômodo de destino>\n");
+    printf("  --medir-rotas <cômodos>\n");
+    printf("  --grafo <planta>\n");
+    printf("  --medir-alcance <cômodos> [threads]\n");
+    printf("  --medir-memoria <cômodos> [threads]\n");
+    printf("  --memoria-pistas [cômodos]\n");
+    printf("  --estresse-placar [threads incrementos]\n");
+    printf("  --medir-dicas [cômodos [operações]]\n");
+    printf("  --medir-alocacoes [cômodos [partidas]]\n");
+    printf("  --exportar-sessoes <arquivo> [sessões [cômodos [linhas por lote]]]\n");
+    printf("  --ler-sessoes <arquivo>\n");
+    printf("  --servidor <socket|porta> [cômodos]\n");
+    printf("  --carga <socket|porta> <conexões,...> [movimentos]\n");
+    printf("  --conferir-servidor\n");
+}
+
+// Lê o argumento 'indice' como inteiro em [minimo, maximo]. Argumento ausente
+// mantém '*valor' (o padrão do modo); texto que não é número inteiro é erro.
+int lerArgumento(int argc, char* argv[], int indice, long long minimo, long long maximo, long long* valor) {
+    if (indice >= argc) return 1;
+    char* fim;
+    errno = 0;
+    long long lido = strtoll(argv[indice], &fim, 10);
+    if (errno != 0 || fim == argv[indice] || *fim != '\0' || lido < minimo || lido > maximo) {
+        printf("Argumento inválido para %s: '%s'\n", argv[1], argv[indice]);
+        return 0;
+    }
+    *valor = lido;
+    return 1;
+}
+
+// Executa um modo utilitário. Modo desconhecido ou argumentos fora do formato
+// mostram o uso e retornam 2, sem cair no jogo interativo.
+int executarModo(int argc, char* argv[]) {
+    const char* modo = argv[1];
+    long long a = 0, b = 0, c = 0;
+    int ok = 0;
+
+    if (strcmp(modo, "--rota") == 0) {
+        if (argc == 4) {
+            ArmazemPistas armazem;
+            inicializarArmazem(&armazem);
+            Comodo* mansao = montarMapa(&armazem);
+            int resultado = mostrarRota(mansao, argv[2], argv[3]);
+            liberarMapa(mansao);
+            liberarArmazem(&armazem);
+            return resultado;
+        }
+    } else if (strcmp(modo, "--medir-rotas") == 0) {
+        if (argc == 3 && lerArgumento(argc, argv, 2, 0, INT_MAX, &a)) return medirConsultasDeRota((int)a);
+    } else if (strcmp(modo, "--grafo") == 0) {
+        if (argc == 3) return jogarGrafo(argv[2]);
+    } else if (strcmp(modo, "--medir-alcance") == 0) {
+        b = threadsDisponiveis();
+        ok = (argc == 3 || argc == 4) && lerArgumento(argc, argv, 2, 0, INT_MAX, &a) &&
+             lerArgumento(argc, argv, 3, 1, 4096, &b);
+        if (ok) return medirAlcance((int)a, (int)b);
+    } else if (strcmp(modo, "--medir-memoria") == 0) {
+        b = threadsDisponiveis();
+        ok = (argc == 3 || argc == 4) && lerArgumento(argc, argv, 2, 0, INT_MAX, &a) &&
+             lerArgumento(argc, argv, 3, 1, 4096, &b);
+        if (ok) return medirMemoria((int)a, (int)b);
+    } else if (strcmp(modo, "--memoria-pistas") == 0) {
+        a = 100000;
+        if ((argc == 2 || argc == 3) && lerArgumento(argc, argv, 2, 0, INT_MAX, &a)) return medirMemoriaPistas((int)a);
+    } else if (strcmp(modo, "--estresse-placar") == 0) {
+        a = threadsDisponiveis() * 2;
+        b = 1000000;
+        ok = (argc == 2 || argc == 4) && lerArgumento(argc, argv, 2, 1, 4096, &a) &&
+             lerArgumento(argc, argv, 3, 1, LONG_MAX, &b);
+        if (ok) return estressarPlacar((int)a, (long)b);
+    } else if (strcmp(modo, "--gerar-tabela") == 0) {
+        if (argc == 5) return gerarTabelaMansao(argv[2], argv[3], argv[4]);
+    } else if (strcmp(modo, "--conferir-tabela") == 0) {
+        if (argc == 2) return conferirMansaoEstatica();
+    } else if (strcmp(modo, "--medir-dicas") == 0) {
+        a = 1000000;
+        b = 1000;
+        ok = argc <= 4 && lerArgumento(argc, argv, 2, 0, INT_MAX, &a) && lerArgumento(argc, argv, 3, 0, INT_MAX, &b);
+        if (ok) return medirDicas((int)a, (int)b);
+    } else if (strcmp(modo, "--medir-alocacoes") == 0) {
+        a = 100000;
+        b = 100000;
+        ok = argc <= 4 && lerArgumento(argc, argv, 2, 1, INT_MAX, &a) && lerArgumento(argc, argv, 3, 1, INT_MAX, &b);
+        if (ok) return medirAlocacoes((int)a, (int)b);
+    } else if (strcmp(modo, "--exportar-sessoes") == 0) {
+        a = 100000;
+        b = 0;
+        c = LINHAS_POR_LOTE;
+        ok = argc >= 3 && argc <= 6 && lerArgumento(argc, argv, 3, 0, LLONG_MAX, &a) &&
+             lerArgumento(argc, argv, 4, 0, INT_MAX, &b) && lerArgumento(argc, argv, 5, 1, INT_MAX, &c);
+        if (ok) return exportarSessoes(argv[2], a, (int)b, (int)c);
+    } else if (strcmp(modo, "--ler-sessoes") == 0) {
+        if (argc == 3) return lerSessoesExportadas(argv[2]);
+    } else if (strcmp(modo, "--servidor") == 0) {
+        ok = (argc == 3 || argc == 4) && lerArgumento(argc, argv, 3, 0, INT_MAX, &a);
+        if (ok) return executarServidor(argv[2], (int)a);
+    } else if (strcmp(modo, "--conferir-servidor") == 0) {
+        if (argc == 2) return conferirServidor();
+    } else if (strcmp(modo, "--carga") == 0) {
+        a = 100;
+        ok = (argc == 4 || argc == 5) && lerArgumento(argc, argv, 4, 1, INT_MAX, &a);
+        if (ok) return executarCarga(argv[2], argv[3], (int)a);
+    } else {
+        printf("Modo desconhecido: %s\n", modo);
+    }
+    exibirUso();
+    return 2;
+}
+
+int main(int argc, char* argv[]) {
+    // Modos utilitários (não interativos)
+    if (argc > 1) return executarModo(argc, argv);
+
+    PistaBST* pistas_coletadas = NULL;
+    TabelaHash hash_suspeitos;
+
+    // Inicializa a Tabela Hash antes do uso
+    inicializarHash(&hash_suspeitos);
+
+    printf("--- Simulador de Mansão e Resolução de Caso (Árvore + BST + Hash) ---\n");
+
+    // 1. A mansão de demonstração já vem pronta da tabela gerada (mansao_demo.h):
+    //    mapa indexado e motor são constantes; só o resumo da partida é alocado
+    MapaIndexado mapa;
+    MotorExploracao motor;
+    ResumoSubarvores resumo;
+    ArmazemPistas armazemMontado;
+    Comodo* montada;
+    const ArmazemPistas* armazem = abrirMansaoDemo(&mapa, &motor, &resumo, &armazemMontado, &montada);
+
+    // 2. Inicia a exploração, coleta de pistas e associação via Hash
+    explorar(&mapa, &pistas_coletadas, &hash_suspeitos, armazem, &resumo);
+
+    // 3. Avaliação final e acusação
+    avaliarAcusacao(&hash_suspeitos);
+
+    // 4. Exibe o relatório de pistas coletadas
+    printf("\n========================================================\n");
+    printf("           📋 RELATÓRIO COMPLETO DE INDÍCIOS 📋          \n");
+    printf("========================================================\n");
+    if (pistas_coletadas != NULL) {
+        exibirPistasEmOrdem(pistas_coletadas, armazem);
+    } else {
+        printf("Nenhuma pista foi coletada.\n");
+    }
+
+    // 5. Libera a memória alocada
+    printf("\n--- Fim da Simulação. Liberando memória ---\n");
+    liberarPistas(pistas_coletadas);
+    liberarResumo(&resumo);
+    liberarMotor(&motor);
+    liberarMapaIndexado(&mapa);
+    liberarMapa(montada);
+    liberarArmazem(&armazemMontado);
     liberarHash(&hash_suspeitos);
 
     return 0;
@@ -0,0 +1,148 @@
+// Gerado por: ./mestre --gerar-tabela demo <saída> MANSAO_DEMO
+// Não edite à mão: altere a mansão de origem e gere de novo.
+#ifndef MANSAO_DEMO_H
+#define MANSAO_DEMO_H
+
+// Textos comprimidos das pistas
+static const uint32_t MANSAO_DEMO_INICIO[7] = {
+    0, 45, 96, 135, 195, 245, 291,
+};
+
+static const uint32_t MANSAO_DEMO_COMPRIMENTO[6] = {
+    45, 51, 39, 60, 50, 46,
+};
+
+static const unsigned char MANSAO_DEMO_DADOS[291] = {
+    65, 32, 112, 111, 114, 116, 97, 32, 112, 114, 105, 110,
+    99, 105, 112, 97, 108, 32, 101, 115, 116, 97, 118, 97,
+    32, 116, 114, 97, 110, 99, 97, 100, 97, 32, 112, 111,
+    114, 32, 100, 101, 110, 116, 114, 111, 46, 85, 109, 32,
+    98, 105, 108, 104, 101, 116, 101, 32, 114, 97, 115, 103,
+    97, 100, 111, 32, 109, 101, 110, 99, 105, 111, 110, 97,
+    32, 39, 101, 110, 99, 111, 110, 116, 114, 111, 32, 110,
+    97, 32, 100, 101, 115, 112, 101, 110, 115, 97, 39, 46,
+    79, 32, 100, 105, 195, 161, 114, 105, 111, 32, 109, 101,
+    110, 99, 105, 111, 110, 97, 32, 117, 109, 32, 114, 101,
+    108, 195, 179, 103, 105, 111, 32, 100, 101, 32, 111, 117,
+    114, 111, 46, 85, 109, 97, 32, 108, 117, 118, 97, 32,
+    100, 101, 32, 115, 101, 100, 97, 32, 118, 101, 114, 109,
+    101, 108, 104, 97, 32, 102, 111, 105, 32, 101, 110, 99,
+    111, 110, 116, 114, 97, 100, 97, 32, 112, 114, 195, 179,
+    120, 105, 109, 97, 32, 97, 111, 32, 108, 97, 118, 97,
+    98, 111, 46, 85, 109, 97, 32, 108, 97, 110, 116, 101,
+    114, 110, 97, 32, 113, 117, 101, 98, 114, 97, 100, 97,
+    32, 101, 32, 109, 97, 114, 99, 97, 115, 32, 100, 101,
+    32, 112, 195, 169, 115, 32, 101, 110, 108, 97, 109, 101,
+    97, 100, 111, 115, 46, 79, 32, 114, 101, 108, 195, 179,
+    103, 105, 111, 32, 100, 101, 32, 111, 117, 114, 111, 32,
+    101, 115, 116, 97, 118, 97, 32, 99, 97, 195, 173, 100,
+    111, 32, 110, 111, 32, 112, 97, 114, 97, 112, 101, 105,
+    116, 111, 46,
+};
+
+// Capacidades zeradas: armazém fixo, não recebe pistas novas
+static const ArmazemPistas MANSAO_DEMO_ARMAZEM = {
+    .simbolos = 0,
+    .treinado = 1,
+    .quantidade = 6,
+    .inicio = MANSAO_DEMO_INICIO,
+    .comprimento = MANSAO_DEMO_COMPRIMENTO,
+    .dados = MANSAO_DEMO_DADOS,
+    .usado = 291,
+};
+
+// Cômodos em pré-ordem (raiz no id 0); filhos por id, -1 se não houver
+#define MANSAO_DEMO_QUANTIDADE 7
+
+static const ComodoIndexado MANSAO_DEMO_COMODOS[7] = {
+    [0] = { .nome = "Hall de Entrada", .pista = 0, .suspeito_associado = "Elias", .esquerda = 1, .direita = 5 },
+    [1] = { .nome = "Sala de Estar", .pista = 1, .suspeito_associado = "Diana", .esquerda = 2, .direita = 4 },
+    [2] = { .nome = "Quarto Principal", .pista = 2, .suspeito_associado = "Elias", .esquerda = 3, .direita = -1 },
+    [3] = { .nome = "Varanda", .pista = 5, .suspeito_associado = "Elias", .esquerda = -1, .direita = -1 },
+    [4] = { .nome = "Banheiro", .pista = 3, .suspeito_associado = "Bruno", .esquerda = -1, .direita = -1 },
+    [5] = { .nome = "Cozinha", .pista = -1, .suspeito_associado = "", .esquerda = 6, .direita = -1 },
+    [6] = { .nome = "Despensa", .pista = 4, .suspeito_associado = "Diana", .esquerda = -1, .direita = -1 },
+};
+
+// Mapa indexado (seção 8): pai, profundidade, fim da subárvore, ordem por nome e
+// tabela esparsa (3 níveis)
+static const int MANSAO_DEMO_PAI[7] = {
+    -1, 0, 1, 2, 1, 0, 5,
+};
+
+static const int MANSAO_DEMO_PROFUNDIDADE[7] = {
+    0, 1, 2, 3, 2, 1, 2,
+};
+
+static const int MANSAO_DEMO_FIM_SUBARVORE[7] = {
+    6, 4, 3, 3, 4, 6, 6,
+};
+
+static const int MANSAO_DEMO_POR_NOME[7] = {
+    4, 5, 6, 0, 2, 1, 3,
+};
+
+static const int MANSAO_DEMO_ESPARSA[21] = {
+    0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 4, 5,
+    5, 6, 0, 1, 5, 5, 5, 5, 6,
+};
+
+// Sem 'bloco': liberarMapaIndexado não libera nada
+static const MapaIndexado MANSAO_DEMO_MAPA = {
+    .quantidade = MANSAO_DEMO_QUANTIDADE,
+    .comodos = MANSAO_DEMO_COMODOS,
+    .pai = MANSAO_DEMO_PAI,
+    .profundidade = MANSAO_DEMO_PROFUNDIDADE,
+    .fimSubarvore = MANSAO_DEMO_FIM_SUBARVORE,
+    .porNome = MANSAO_DEMO_POR_NOME,
+    .niveis = 3,
+    .esparsa = MANSAO_DEMO_ESPARSA,
+};
+
+// Motor de exploração (seção 12): 6 pistas, 6 textos distintos, 3 suspeitos
+static const unsigned char MANSAO_DEMO_TEM_PISTA[7] = {
+    1, 1, 1, 1, 1, 0, 1,
+};
+
+static const int MANSAO_DEMO_INDICE_PISTA[7] = {
+    0, 1, 2, 3, 4, -1, 5,
+};
+
+static const int MANSAO_DEMO_ORDEM_PISTA[7] = {
+    0, 3, 1, 2, 5, -1, 4,
+};
+
+static const int MANSAO_DEMO_SUSPEITO_DE[7] = {
+    2, 1, 2, 2, 0, -1, 1,
+};
+
+static const char* const MANSAO_DEMO_NOME_SUSPEITO[3] = {
+    "Bruno",
+    "Diana",
+    "Elias",
+};
+
+static const MotorExploracao MANSAO_DEMO_MOTOR = {
+    .mapa = &MANSAO_DEMO_MAPA,
+    .quantidade = MANSAO_DEMO_QUANTIDADE,
+    .temPista = MANSAO_DEMO_TEM_PISTA,
+    .indicePista = MANSAO_DEMO_INDICE_PISTA,
+    .ordemPista = MANSAO_DEMO_ORDEM_PISTA,
+    .suspeitoDe = MANSAO_DEMO_SUSPEITO_DE,
+    .totalPistas = 6,
+    .pistasDistintas = 6,
+    .suspeitos = 3,
+    .nomeSuspeito = MANSAO_DEMO_NOME_SUSPEITO,
+};
+
+// Resumo por subárvore (seção 13) sem nenhuma pista coletada: cada partida o copia
+static const int MANSAO_DEMO_RESTANTES[21] = {
+    1, 2, 3, 1, 1, 2, 0, 0, 2, 0, 0, 1,
+    1, 0, 0, 0, 1, 0, 0, 1, 0,
+};
+
+static const int MANSAO_DEMO_TOTAL_RESTANTE[7] = {
+    6, 4, 2, 1, 1, 1, 1,
+};
+
+#endif // MANSAO_DEMO_H